@@ -0,0 +1,669 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+// Fuzzing and differential validation of exploration and solving
+// Every input is turned into a maze and run through the whole simulation. Memory errors are found by
+// AddressSanitizer, the other checks abort with the maze that made them fail:
+//   - shortest paths of the solvers are compared with a simple reference Flood Fill on the route
+//   - the exploration of a maze following the competition rules always ends: coming back to a state it has
+//     already been in means it never would
+//   - Solving and Plan_Route must give a real route through the maze
+//   - Cached_Features must give the same results as Maze_Features for the 8 ways the maze can be turned
+//   - the maze written as text, and the input itself, must be read the same way from memory (SSE2 fast paths)
+//     and through a stream (-DREADER_BUFFER=7 keeps it to the character by character path)
+//
+// libFuzzer:  clang -g -O1 -fsanitize=fuzzer,address,undefined -DFUZZ_LIBFUZZER -DREADER_BUFFER=7 fuzz_maze.c maze_cache.c maze_io.c maze_stats.c micromouse.c -o fuzz_maze -lpthread
+// Standalone: gcc -g -O1 -fsanitize=address,undefined -DREADER_BUFFER=7 fuzz_maze.c maze_cache.c maze_io.c maze_stats.c micromouse.c -o fuzz_maze -lpthread
+//             fuzz_maze [iterations] [seed]   or   fuzz_maze <input files>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "micromouse.h"
+#include "maze_stats.h"
+#include "maze_cache.h"
+#include "maze_io.h"
+
+#define MAX_FUZZ_MOVES 5000 // Moves after which the exploration is considered stuck if no loop has been found
+#define FUZZ_INPUT_SIZE 64  // Bytes of the random inputs of the standalone driver
+#define FUZZ_CACHE_MOVES 200 // Exploration budget of the cache check
+#define FUZZ_CACHE_SIZE 65536 // Mazes kept in the cache before starting again
+#define FUZZ_TEXT_SIZE 2048   // Longest maze written as text
+
+// First Byte of the Input
+#define FUZZ_WIDE 0b01      // 1 - 8x6 maze instead of 6x8
+#define FUZZ_GENERATED 0b10 // 2 - Input used as seed of a maze following the competition rules
+
+// Everything the next move depends on
+struct Fuzz_State
+{
+    struct Mouse_Settings mouse;
+    unsigned int mouse_maze[SIZE][SIZE];
+    unsigned int discovered_cells[SIZE][SIZE];
+};
+
+unsigned long long fuzz_rules_mazes;
+struct Maze_Cache fuzz_cache;
+unsigned int fuzz_cache_ready;
+
+unsigned int Fuzz_Random(uint32_t *p_state)
+{
+    // xorshift32
+    *p_state ^= *p_state << 13;
+    *p_state ^= *p_state >> 17;
+    *p_state ^= *p_state << 5;
+    return *p_state;
+}
+
+// Opening the passage between a cell and its neighbour (route rows are written from the top)
+void Fuzz_Open(struct Maze_Route *p_route, unsigned int r, unsigned int c, unsigned int dir)
+{
+    if (dir == NORTH)
+    {
+        p_route->cells[r][c] |= NORTH_WALL;
+        p_route->cells[r - 1][c] |= SOUTH_WALL;
+    }
+    else if (dir == EAST)
+    {
+        p_route->cells[r][c] |= EAST_WALL;
+        p_route->cells[r][c + 1] |= WEST_WALL;
+    }
+    else if (dir == SOUTH)
+    {
+        p_route->cells[r][c] |= SOUTH_WALL;
+        p_route->cells[r + 1][c] |= NORTH_WALL;
+    }
+    else
+    {
+        p_route->cells[r][c] |= WEST_WALL;
+        p_route->cells[r][c - 1] |= EAST_WALL;
+    }
+}
+
+// Maze following the competition rules: perfect maze, first cell open to the north only, open centre square
+void Fuzz_Generate(struct Maze_Route *p_route, uint32_t seed, const uint8_t *data, size_t size)
+{
+    unsigned int stack[TOT_CELLS], seen[SIZE][SIZE], dirs[4];
+    unsigned int r, c, i, dir, top = 0, count, start_r = p_route->rows - 1;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            seen[r][c] = 0;
+
+    // Depth-first carving from the cell in front of the first one
+    seen[start_r][0] = 1;
+    Fuzz_Open(p_route, start_r, 0, NORTH);
+    seen[start_r - 1][0] = 1;
+    stack[top++] = (start_r - 1) * SIZE;
+    while (top)
+    {
+        r = stack[top - 1] / SIZE;
+        c = stack[top - 1] % SIZE;
+
+        count = 0;
+        if ((r > 0) && !seen[r - 1][c])
+            dirs[count++] = NORTH;
+        if ((c < p_route->cols - 1) && !seen[r][c + 1])
+            dirs[count++] = EAST;
+        if ((r < p_route->rows - 1) && !seen[r + 1][c])
+            dirs[count++] = SOUTH;
+        if ((c > 0) && !seen[r][c - 1])
+            dirs[count++] = WEST;
+
+        if (count == 0)
+        {
+            top--;
+            continue;
+        }
+
+        dir = dirs[Fuzz_Random(&seed) % count];
+        Fuzz_Open(p_route, r, c, dir);
+        r = r - (dir == NORTH) + (dir == SOUTH);
+        c = c + (dir == EAST) - (dir == WEST);
+        seen[r][c] = 1;
+        stack[top++] = r * SIZE + c;
+    }
+
+    // Extra passages (loops) chosen by the input
+    for (i = 0; i + 1 < size; i += 2)
+    {
+        r = data[i] % (p_route->rows - 1);
+        c = data[i + 1] % (p_route->cols - 1);
+        if ((r != start_r - 1) || (c != 0))
+            Fuzz_Open(p_route, r, c, (data[i] & 0x80) ? SOUTH : EAST);
+    }
+
+    // Destination square
+    r = (p_route->rows / 2) - 1;
+    c = (p_route->cols / 2) - 1;
+    Fuzz_Open(p_route, r, c, EAST);
+    Fuzz_Open(p_route, r, c, SOUTH);
+    Fuzz_Open(p_route, r + 1, c + 1, NORTH);
+    Fuzz_Open(p_route, r + 1, c + 1, WEST);
+}
+
+// Reference shortest path - Flood Fill straight on the route
+// Two cells are connected if either of them has no wall between them
+unsigned int Reference_Path(const struct Maze_Route *p_route, unsigned int to_r, unsigned int to_c, unsigned int targets[SIZE][SIZE], unsigned int *p_reached)
+{
+    int dist[SIZE][SIZE], queue[SIZE * SIZE], head = 0, tail = 0;
+    int rows = p_route->rows, cols = p_route->cols, r, c, next_r, next_c, dir;
+    const int move_r[4] = {1, 0, -1, 0}, move_c[4] = {0, 1, 0, -1};
+    const unsigned int wall[4] = {NORTH_WALL, EAST_WALL, SOUTH_WALL, WEST_WALL}, back_wall[4] = {SOUTH_WALL, WEST_WALL, NORTH_WALL, EAST_WALL};
+
+    // Simulation coordinates: row 0 is the bottom row of the route
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            dist[r][c] = -1;
+    dist[to_r][to_c] = 0;
+    queue[tail++] = to_r * SIZE + to_c;
+    *p_reached = 1;
+
+    while (head != tail)
+    {
+        r = queue[head] / SIZE;
+        c = queue[head] % SIZE;
+        head++;
+        if (targets[r][c])
+            return dist[r][c];
+
+        for (dir = 0; dir < 4; dir++)
+        {
+            next_r = r + move_r[dir];
+            next_c = c + move_c[dir];
+            if ((next_r < 0) || (next_r >= rows) || (next_c < 0) || (next_c >= cols) || (dist[next_r][next_c] != -1))
+                continue;
+            if (((p_route->cells[rows - 1 - r][c] & wall[dir]) == 0) && ((p_route->cells[rows - 1 - next_r][next_c] & back_wall[dir]) == 0))
+                continue;
+            dist[next_r][next_c] = dist[r][c] + 1;
+            queue[tail++] = next_r * SIZE + next_c;
+            *p_reached += 1;
+        }
+    }
+
+    return NO_ROUTE;
+}
+
+void Fuzz_Fail(const struct Maze_Route *p_route, const char *message, unsigned int expected, unsigned int found)
+{
+    unsigned int r, c;
+
+    fprintf(stderr, "FUZZ FAILURE: %s (expected %u, found %u)\n", message, expected, found);
+    for (r = 0; r < p_route->rows; r++)
+    {
+        fprintf(stderr, "{");
+        for (c = 0; c < p_route->cols; c++)
+            fprintf(stderr, (c + 1 < p_route->cols) ? "%u," : "%u", p_route->cells[r][c]);
+        fprintf(stderr, (r + 1 < p_route->rows) ? "},\n" : "}\n");
+    }
+    abort();
+}
+
+// Checking that the marked cells go from the first cell to destination through open passages
+unsigned int Route_Length(unsigned int maze[SIZE][SIZE], unsigned int mouse_maze[SIZE][SIZE], unsigned int mark, const struct Maze_Route *p_route)
+{
+    unsigned int r = 0, c = 0, prev_r = SIZE, prev_c = SIZE, next_r, next_c, moves = 0, dir, found;
+
+    if ((mouse_maze[0][0] & mark) != mark)
+        Fuzz_Fail(p_route, "route does not start from the first cell", 1, 0);
+
+    while ((mouse_maze[r][c] & DEST_CELL) != DEST_CELL)
+    {
+        found = 0;
+        for (dir = NORTH; (dir <= WEST) && !found; dir++)
+        {
+            if ((maze[r][c] & (NORTH_WALL >> dir)) != 0)
+                continue;
+            next_r = r + (dir == NORTH) - (dir == SOUTH);
+            next_c = c + (dir == EAST) - (dir == WEST);
+            if ((next_r >= p_route->rows) || (next_c >= p_route->cols) || ((next_r == prev_r) && (next_c == prev_c)))
+                continue;
+            if ((mouse_maze[next_r][next_c] & mark) == mark)
+                found = 1;
+        }
+        if (!found)
+            Fuzz_Fail(p_route, "route is broken", 1, 0);
+
+        prev_r = r;
+        prev_c = c;
+        r = next_r;
+        c = next_c;
+        if (++moves > TOT_CELLS)
+            Fuzz_Fail(p_route, "route goes round in a loop", TOT_CELLS, moves);
+    }
+
+    return moves;
+}
+
+void Fuzz_Maze(const struct Maze_Route *p_route)
+{
+    unsigned int maze[SIZE][SIZE], dist[SIZE][SIZE];
+    unsigned int targets[SIZE][SIZE], path[SIZE][SIZE];
+    unsigned int r, c, reached, reference, moves = 0, count = 2, rules, power = 1;
+    struct Fuzz_State state, saved;
+    struct Plan_Cache plan_cache;
+    const struct Route_Plan *p_plan;
+
+    Generate_Maze(maze);
+    Generate_Route(maze, p_route);
+
+    //--- Shortest path to the centre square ---
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            targets[r][c] = ((r == p_route->rows / 2 - 1) || (r == p_route->rows / 2)) &&
+                            ((c == p_route->cols / 2 - 1) || (c == p_route->cols / 2));
+    reference = Reference_Path(p_route, 0, 0, targets, &reached);
+
+    Maze_Distances(maze, p_route->rows, p_route->cols, dist);
+    if (dist[0][0] != reference)
+        Fuzz_Fail(p_route, "Maze_Distances shortest path", reference, dist[0][0]);
+
+    // Competition rules: every cell can be reached, first cell only open to the north, open destination square
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            path[r][c] = 0;
+    Reference_Path(p_route, 0, 0, path, &reached);
+    rules = (reached == TOT_CELLS) && ((maze[0][0] & BITS) == (BITS ^ NORTH_WALL));
+    r = (p_route->rows / 2) - 1;
+    c = (p_route->cols / 2) - 1;
+    rules = rules && ((maze[r][c] & (NORTH_WALL | EAST_WALL)) == 0) && ((maze[r + 1][c + 1] & (SOUTH_WALL | WEST_WALL)) == 0);
+
+    //--- Exploration ---
+    Mouse_Setup(&state.mouse);
+    Mouse_Maze_Setup(state.mouse_maze);
+    Plan_Cache_Setup(&plan_cache);
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            state.discovered_cells[r][c] = 0;
+    state.discovered_cells[0][0] = 1;
+    saved = state;
+
+    fuzz_rules_mazes += rules;
+
+    while ((state.mouse.cells_found != TOT_CELLS) || (state.mouse.pos_y != 0) || (state.mouse.pos_x != 0))
+    {
+        Mouse_Exploring(maze, state.mouse_maze, &state.mouse, state.discovered_cells);
+        Walls_Check(maze, &state.mouse, state.mouse_maze);
+        moves++;
+
+        if ((state.mouse.pos_y >= p_route->rows) || (state.mouse.pos_x >= p_route->cols))
+            Fuzz_Fail(p_route, "mouse left the maze", 0, state.mouse.pos_y * SIZE + state.mouse.pos_x);
+
+        if (state.discovered_cells[state.mouse.pos_y][state.mouse.pos_x] == 0)
+            state.discovered_cells[state.mouse.pos_y][state.mouse.pos_x] = count++;
+
+        p_plan = Plan_Route(state.mouse_maze, &plan_cache);
+        if ((p_plan->known_len != NO_ROUTE) && (p_plan->optimistic_len > p_plan->known_len))
+            Fuzz_Fail(p_route, "Plan_Route lower bound above the known route", p_plan->known_len, p_plan->optimistic_len);
+
+        // Same state as before - the mouse is going round in a loop forever (Brent's cycle detection)
+        if ((memcmp(&state, &saved, sizeof(state)) == 0) || (moves == MAX_FUZZ_MOVES))
+        {
+            if (rules)
+                Fuzz_Fail(p_route, "exploration does not end", 0, moves);
+            return;
+        }
+        if (moves == power)
+        {
+            saved = state;
+            power *= 2;
+        }
+    }
+
+    if (!rules)
+        return;
+
+    //--- Solving ---
+    // Destination is now the cells found by the mouse
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            targets[r][c] = (state.mouse_maze[r][c] & DEST_CELL) == DEST_CELL;
+    reference = Reference_Path(p_route, 0, 0, targets, &reached);
+
+    // The known route of a fully explored maze is the shortest one
+    p_plan = Plan_Route(state.mouse_maze, &plan_cache);
+    if ((p_plan->known_len != reference) || (p_plan->bound != 0))
+        Fuzz_Fail(p_route, "Plan_Route shortest path", reference, p_plan->known_len);
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            path[r][c] = state.mouse_maze[r][c] & DEST_CELL;
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            if (p_plan->route[r][c])
+                path[r][c] |= CELL_USED;
+    if (Route_Length(maze, path, CELL_USED, p_route) != reference)
+        Fuzz_Fail(p_route, "Plan_Route route length", reference, Route_Length(maze, path, CELL_USED, p_route));
+
+    // The discovered cells order gives a route, not always the shortest one
+    Solving(state.mouse_maze, state.discovered_cells);
+    moves = Route_Length(maze, state.mouse_maze, CELL_USED, p_route);
+    if (moves < reference)
+        Fuzz_Fail(p_route, "Solving route shorter than the shortest path", reference, moves);
+}
+
+// Turning the route cell by cell - independent from the packed passages of maze_cache
+void Fuzz_Turn(const struct Maze_Route *p_route, unsigned int transform, struct Maze_Route *p_turned)
+{
+    unsigned int r, c, to_r, to_c, temp, cell;
+
+    p_turned->rows = ((transform & TRANSPOSE) == TRANSPOSE) ? p_route->cols : p_route->rows;
+    p_turned->cols = ((transform & TRANSPOSE) == TRANSPOSE) ? p_route->rows : p_route->cols;
+
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+        {
+            cell = p_route->cells[(p_route->rows - 1) - r][c]; // Routes are written from the top row
+            to_r = r;
+            to_c = c;
+
+            if ((transform & MIRROR_COLS) == MIRROR_COLS)
+            {
+                to_c = (p_route->cols - 1) - to_c;
+                cell = (cell & (NORTH_WALL | SOUTH_WALL)) | ((cell & EAST_WALL) ? WEST_WALL : 0) | ((cell & WEST_WALL) ? EAST_WALL : 0);
+            }
+            if ((transform & MIRROR_ROWS) == MIRROR_ROWS)
+            {
+                to_r = (p_route->rows - 1) - to_r;
+                cell = (cell & (EAST_WALL | WEST_WALL)) | ((cell & NORTH_WALL) ? SOUTH_WALL : 0) | ((cell & SOUTH_WALL) ? NORTH_WALL : 0);
+            }
+            if ((transform & TRANSPOSE) == TRANSPOSE)
+            {
+                temp = to_r;
+                to_r = to_c;
+                to_c = temp;
+                cell = ((cell & NORTH_WALL) ? EAST_WALL : 0) | ((cell & EAST_WALL) ? NORTH_WALL : 0) |
+                       ((cell & SOUTH_WALL) ? WEST_WALL : 0) | ((cell & WEST_WALL) ? SOUTH_WALL : 0);
+            }
+
+            p_turned->cells[(p_turned->rows - 1) - to_r][to_c] = cell;
+        }
+}
+
+// Every turned copy must have the same canonical key and the cached results must be the computed ones
+void Fuzz_Cache(const struct Maze_Route *p_route)
+{
+    const struct Explore_Budget budget = {FUZZ_CACHE_MOVES, 0, 0};
+    struct Maze_Route turned;
+    struct Maze_Key key, first_key;
+    struct Maze_Stats computed, cached;
+    unsigned int transform, canonical_transform, result;
+
+    // libFuzzer only keeps the input that failed - the cache starts empty for every input so that it can be replayed
+#ifdef FUZZ_LIBFUZZER
+    if (fuzz_cache_ready)
+#else
+    if (fuzz_cache_ready && (fuzz_cache.count >= FUZZ_CACHE_SIZE))
+#endif
+    {
+        Maze_Cache_Close(&fuzz_cache);
+        fuzz_cache_ready = 0;
+    }
+    if (!fuzz_cache_ready)
+    {
+        if (Maze_Cache_Setup(&fuzz_cache) != 0)
+            Fuzz_Fail(p_route, "cache setup", 0, 1);
+        fuzz_cache_ready = 1;
+    }
+
+    // Every orientation twice - the second time they have all been explored, nothing can be computed again
+    for (transform = 0; transform < 16; transform++)
+    {
+        Fuzz_Turn(p_route, transform % 8, &turned);
+
+        Maze_Canonical(&turned, &key, &canonical_transform);
+        if (transform == 0)
+            first_key = key;
+        else if ((key.rows != first_key.rows) || (key.cols != first_key.cols) || (key.north != first_key.north) || (key.east != first_key.east))
+            Fuzz_Fail(p_route, "canonical key of the turned maze", 0, transform);
+
+        Maze_Features(&turned, &budget, &computed);
+        result = Cached_Features(&fuzz_cache, &turned, &budget, &cached);
+        if (memcmp(&computed, &cached, sizeof(computed)) != 0)
+            Fuzz_Fail(&turned, "Cached_Features differs from Maze_Features", 0, transform);
+        if ((transform >= 8) && (result != CACHE_HIT))
+            Fuzz_Fail(&turned, "orientation already explored not found in the cache", CACHE_HIT, result);
+    }
+}
+
+// Writing the route as in mazes.txt - spacing, line ends, comments and braces chosen by the seed
+// Returns the length of the text, *p_clean is set if it is well written (all values fit, no character changed)
+size_t Fuzz_Text(const struct Maze_Route *p_route, uint32_t seed, char *text, unsigned int *p_clean)
+{
+    const char *separators[] = {",", ", ", " ,", ",\t", ",  "};
+    const char *line_ends[] = {",\n", ",\r\n", ",\n        ", ", ", ",\n\t"};
+    const char *numbers[] = {"%u", "%u", "%u", "%u", "%u", "%u", "%02u", "%03u", "1%03u"}; // Last one above BITS
+    const char *noise = "{},/ 9x\n;";
+    unsigned int r, c, outer, format, too_big = 0;
+    size_t len = 0;
+
+    if (Fuzz_Random(&seed) % 2)
+        len += sprintf(text + len, "// --- Testing (%ux%u) ---\n\n\t", p_route->cols, p_route->rows);
+    outer = Fuzz_Random(&seed) % 3 == 0;
+    if (outer)
+        text[len++] = '{';
+
+    for (r = 0; r < p_route->rows; r++)
+    {
+        text[len++] = '{';
+        for (c = 0; c < p_route->cols; c++)
+        {
+            if (c)
+                len += sprintf(text + len, "%s", separators[Fuzz_Random(&seed) % 5]);
+            format = Fuzz_Random(&seed) % ((Fuzz_Random(&seed) % 16) ? 8 : 9);
+            too_big |= (format == 8);
+            len += sprintf(text + len, numbers[format], p_route->cells[r][c]);
+        }
+        text[len++] = '}';
+        if (r + 1 < p_route->rows)
+            len += sprintf(text + len, "%s", line_ends[Fuzz_Random(&seed) % 5]);
+    }
+
+    if (outer)
+        text[len++] = '}';
+    if (Fuzz_Random(&seed) % 2)
+        text[len++] = ';';
+    len += sprintf(text + len, (Fuzz_Random(&seed) % 2) ? "\n\n// --- End ---\n" : "\n");
+
+    // Some texts get a wrong character
+    *p_clean = !too_big;
+    if (Fuzz_Random(&seed) % 4 == 0)
+    {
+        text[Fuzz_Random(&seed) % len] = noise[Fuzz_Random(&seed) % 9];
+        *p_clean = 0;
+    }
+
+    return len;
+}
+
+void Fuzz_Reader_Fail(const uint8_t *text, size_t size, const struct Maze_Route *p_route, const char *message, unsigned int expected, unsigned int found)
+{
+    fprintf(stderr, "--- text ---\n%.*s\n------------\n", (int)size, (const char *)text);
+    Fuzz_Fail(p_route, message, expected, found);
+}
+
+// The same text read from memory and through a stream must give the same mazes
+// p_expected is the first maze of the text if it is known to be well written
+void Fuzz_Reader(const struct Maze_Route *p_route, const struct Maze_Route *p_expected, const uint8_t *text, size_t size)
+{
+    static struct Maze_Reader mapped, streamed;
+    struct Maze_Route route_mapped, route_streamed;
+    unsigned long long offset_mapped = 0, offset_streamed = 0;
+    unsigned long line_mapped = 0, line_streamed = 0;
+    int result_mapped, result_streamed;
+    unsigned int r, first = 1;
+    FILE *file;
+
+    if (size == 0)
+        return;
+    file = fmemopen((void *)text, size, "r");
+    if (file == NULL)
+        Fuzz_Reader_Fail(text, size, p_route, "fmemopen", 0, 1);
+    Maze_Reader_Memory(&mapped, text, size);
+    Maze_Reader_Setup(&streamed, file);
+
+    do
+    {
+        result_mapped = Maze_Read_Next(&mapped, &route_mapped, &offset_mapped, &line_mapped);
+        result_streamed = Maze_Read_Next(&streamed, &route_streamed, &offset_streamed, &line_streamed);
+
+        if (result_mapped != result_streamed)
+            Fuzz_Reader_Fail(text, size, p_route, "mapped and stream readers result", result_streamed, result_mapped);
+        if (offset_mapped != offset_streamed)
+            Fuzz_Reader_Fail(text, size, p_route, "mapped and stream readers maze offset", offset_streamed, offset_mapped);
+        if (line_mapped != line_streamed)
+            Fuzz_Reader_Fail(text, size, p_route, "mapped and stream readers maze line", line_streamed, line_mapped);
+        if (result_mapped == 1)
+        {
+            if ((route_mapped.rows != route_streamed.rows) || (route_mapped.cols != route_streamed.cols))
+                Fuzz_Reader_Fail(text, size, p_route, "mapped and stream readers size", route_streamed.rows, route_mapped.rows);
+            for (r = 0; r < route_mapped.rows; r++)
+                if (memcmp(route_mapped.cells[r], route_streamed.cells[r], route_mapped.cols * sizeof(unsigned int)) != 0)
+                    Fuzz_Reader_Fail(text, size, p_route, "mapped and stream readers cells in row", 0, r);
+        }
+
+        // A well written maze is read back as it was
+        if (first && (p_expected != NULL))
+        {
+            if ((result_mapped != 1) || (route_mapped.rows != p_expected->rows) || (route_mapped.cols != p_expected->cols))
+                Fuzz_Reader_Fail(text, size, p_route, "maze written as text not read back", 1, result_mapped);
+            for (r = 0; r < p_expected->rows; r++)
+                if (memcmp(route_mapped.cells[r], p_expected->cells[r], p_expected->cols * sizeof(unsigned int)) != 0)
+                    Fuzz_Reader_Fail(text, size, p_route, "maze written as text read back with other cells in row", 0, r);
+        }
+        first = 0;
+    } while (result_mapped != 0);
+
+    if ((mapped.offset != streamed.offset) || (mapped.line != streamed.line))
+        Fuzz_Reader_Fail(text, size, p_route, "mapped and stream readers end of file", streamed.offset, mapped.offset);
+    fclose(file);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    struct Maze_Route route;
+    char text[FUZZ_TEXT_SIZE];
+    unsigned int r, c, i, clean;
+    uint32_t text_seed = 2166136261u;
+    size_t len;
+
+    if (size < 1)
+        return 0;
+
+    route.rows = (data[0] & FUZZ_WIDE) ? LENGTH : HEIGHT;
+    route.cols = (data[0] & FUZZ_WIDE) ? HEIGHT : LENGTH;
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            route.cells[r][c] = 0;
+
+    if (data[0] & FUZZ_GENERATED)
+    {
+        uint32_t seed = 2463534242u;
+        for (i = 1; (i < 5) && (i < size); i++)
+            seed = (seed * 31) ^ data[i];
+        Fuzz_Generate(&route, seed ? seed : 1, data + 5 * (size > 5), (size > 5) ? size - 5 : 0);
+    }
+    else
+        // Any route - one cell every half byte
+        for (i = 0; i < TOT_CELLS; i++)
+            if (1 + i / 2 < size)
+                route.cells[i / route.cols][i % route.cols] = (i % 2) ? (data[1 + i / 2] >> 4) : (data[1 + i / 2] & BITS);
+
+    Fuzz_Maze(&route);
+    Fuzz_Cache(&route);
+
+    // Reading the maze as text, and the input as it is
+    for (i = 0; i < size; i++)
+        text_seed = (text_seed ^ data[i]) * 16777619u;
+    len = Fuzz_Text(&route, text_seed ? text_seed : 1, text, &clean);
+    Fuzz_Reader(&route, clean ? &route : NULL, (const uint8_t *)text, len);
+    Fuzz_Reader(&route, NULL, data, size);
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+int main(int argc, char *argv[])
+{
+    uint8_t data[FUZZ_INPUT_SIZE];
+    unsigned long long iterations = 0, limit = 0, i;
+    uint32_t seed = (uint32_t)time(NULL);
+    clock_t start = clock(), last = start;
+    FILE *file;
+    size_t size;
+    int a;
+
+    // Running saved inputs
+    if ((argc > 1) && (argv[1][0] < '0' || argv[1][0] > '9'))
+    {
+        for (a = 1; a < argc; a++)
+        {
+            file = fopen(argv[a], "rb");
+            if (file == NULL)
+            {
+                fprintf(stderr, "cannot open %s\n", argv[a]);
+                return 1;
+            }
+            size = fread(data, 1, FUZZ_INPUT_SIZE, file);
+            fclose(file);
+            LLVMFuzzerTestOneInput(data, size);
+            printf("%s: ok\n", argv[a]);
+        }
+        return 0;
+    }
+
+    if (argc > 1)
+        limit = strtoull(argv[1], NULL, 10);
+    if (argc > 2)
+        seed = strtoul(argv[2], NULL, 10);
+    if (seed == 0)
+        seed = 1;
+    printf("seed = %u\n", seed);
+
+    // Random inputs - half of them are generated mazes following the rules
+    while ((limit == 0) || (iterations < limit))
+    {
+        for (i = 0; i < FUZZ_INPUT_SIZE; i++)
+            data[i] = Fuzz_Random(&seed);
+        LLVMFuzzerTestOneInput(data, 1 + Fuzz_Random(&seed) % FUZZ_INPUT_SIZE);
+        iterations++;
+
+        if (clock() - last > 10 * CLOCKS_PER_SEC)
+        {
+            last = clock();
+            printf("%llu inputs\t%.0f inputs/s\t%llu mazes following the rules\n", iterations,
+                   iterations / ((double)(last - start) / CLOCKS_PER_SEC), fuzz_rules_mazes);
+            fflush(stdout);
+        }
+    }
+
+    printf("%llu inputs\t%.0f inputs/s\n", iterations, iterations / ((double)(clock() - start + 1) / CLOCKS_PER_SEC));
+    printf("%llu mazes following the rules explored to the end\n", fuzz_rules_mazes);
+    return 0;
+}
+#endif
@@ -0,0 +1,426 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+// Symmetry-aware result cache
+// Rotated and mirrored copies of a maze share their shape features (shortest path from each corner,
+// loops, dead ends, junctions, branching). The maze is packed one bit per passage and turned in the
+// 8 possible ways, the one with the lowest hash is used as key. The exploration depends on the way
+// the maze is turned so it is only reused for the very same maze.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "maze_cache.h"
+
+struct Cache_Header
+{
+    char magic[4];
+    uint32_t version, entry_size, count;
+};
+
+// Bit c of every row moved to 7 - c
+uint64_t Mirror_Bits(uint64_t x)
+{
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return x;
+}
+
+// Row r moved to 7 - r
+uint64_t Flip_Rows(uint64_t x)
+{
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    x = (x >> 32) | (x << 32);
+    return x;
+}
+
+// Bit r * 8 + c moved to c * 8 + r
+uint64_t Transpose_Bits(uint64_t x)
+{
+    uint64_t t;
+
+    t = 0x0F0F0F0F00000000ULL & (x ^ (x << 28));
+    x ^= t ^ (t >> 28);
+    t = 0x3333000033330000ULL & (x ^ (x << 14));
+    x ^= t ^ (t >> 14);
+    t = 0x5500550055005500ULL & (x ^ (x << 7));
+    x ^= t ^ (t >> 7);
+    return x;
+}
+
+void Key_From_Route(const struct Maze_Route *p_route, struct Maze_Key *p_key)
+{
+    unsigned int r, c, route;
+
+    memset(p_key, 0, sizeof(*p_key));
+    p_key->rows = p_route->rows;
+    p_key->cols = p_route->cols;
+
+    // A passage is open if either cell has no wall on that side (as in Generate_Route)
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+        {
+            route = p_route->cells[(p_route->rows - 1) - r][c]; // Routes are written from the top row
+
+            if ((r < (p_route->rows - 1)) && (((route & NORTH_WALL) == NORTH_WALL) ||
+                                              ((p_route->cells[(p_route->rows - 2) - r][c] & SOUTH_WALL) == SOUTH_WALL)))
+                p_key->north |= 1ULL << (r * 8 + c);
+            if ((c < (p_route->cols - 1)) && (((route & EAST_WALL) == EAST_WALL) ||
+                                              ((p_route->cells[(p_route->rows - 1) - r][c + 1] & WEST_WALL) == WEST_WALL)))
+                p_key->east |= 1ULL << (r * 8 + c);
+        }
+}
+
+// Passages are moved back to the bottom-left corner after every mirror
+void Transform_Key(const struct Maze_Key *p_key, unsigned int transform, struct Maze_Key *p_out)
+{
+    uint64_t north = p_key->north, east = p_key->east;
+
+    memset(p_out, 0, sizeof(*p_out));
+    if ((transform & MIRROR_COLS) == MIRROR_COLS)
+    {
+        north = Mirror_Bits(north) >> (8 - p_key->cols);
+        east = Mirror_Bits(east) >> (9 - p_key->cols);
+    }
+    if ((transform & MIRROR_ROWS) == MIRROR_ROWS)
+    {
+        north = Flip_Rows(north) >> (8 * (9 - p_key->rows));
+        east = Flip_Rows(east) >> (8 * (8 - p_key->rows));
+    }
+    if ((transform & TRANSPOSE) == TRANSPOSE)
+    {
+        p_out->north = Transpose_Bits(east);
+        p_out->east = Transpose_Bits(north);
+        p_out->rows = p_key->cols;
+        p_out->cols = p_key->rows;
+    }
+    else
+    {
+        p_out->north = north;
+        p_out->east = east;
+        p_out->rows = p_key->rows;
+        p_out->cols = p_key->cols;
+    }
+}
+
+void Transform_Point(unsigned int transform, unsigned int rows, unsigned int cols, unsigned int *p_r, unsigned int *p_c)
+{
+    unsigned int temp;
+
+    if ((transform & MIRROR_COLS) == MIRROR_COLS)
+        *p_c = (cols - 1) - *p_c;
+    if ((transform & MIRROR_ROWS) == MIRROR_ROWS)
+        *p_r = (rows - 1) - *p_r;
+    if ((transform & TRANSPOSE) == TRANSPOSE)
+    {
+        temp = *p_r;
+        *p_r = *p_c;
+        *p_c = temp;
+    }
+}
+
+uint64_t Key_Hash(const struct Maze_Key *p_key)
+{
+    uint64_t h = p_key->north ^ (p_key->east * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)p_key->rows << 4 | p_key->cols);
+
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+int Key_Compare(const struct Maze_Key *p_a, const struct Maze_Key *p_b)
+{
+    if (p_a->rows != p_b->rows)
+        return (p_a->rows < p_b->rows) ? -1 : 1;
+    if (p_a->north != p_b->north)
+        return (p_a->north < p_b->north) ? -1 : 1;
+    if (p_a->east != p_b->east)
+        return (p_a->east < p_b->east) ? -1 : 1;
+    return 0;
+}
+
+// Orientation with the lowest hash (lowest key if two hashes are equal)
+// The transform turning the maze into its canonical form is returned as well
+void Maze_Canonical(const struct Maze_Route *p_route, struct Maze_Key *p_key, unsigned int *p_transform)
+{
+    struct Maze_Key key, turned;
+    uint64_t hash, best = 0;
+    unsigned int transform;
+
+    Key_From_Route(p_route, &key);
+    for (transform = 0; transform < 8; transform++)
+    {
+        Transform_Key(&key, transform, &turned);
+        hash = Key_Hash(&turned);
+        if ((transform == 0) || (hash < best) || ((hash == best) && (Key_Compare(&turned, p_key) < 0)))
+        {
+            best = hash;
+            *p_key = turned;
+            *p_transform = transform;
+        }
+    }
+}
+
+// Slot holding the key, or the empty slot where it would go - lock held
+struct Cache_Entry *Cache_Slot(struct Maze_Cache *p_cache, const struct Maze_Key *p_key)
+{
+    unsigned int i = Key_Hash(p_key) & (p_cache->capacity - 1);
+
+    while ((p_cache->entries[i].key.rows != 0) && (Key_Compare(&p_cache->entries[i].key, p_key) != 0))
+        i = (i + 1) & (p_cache->capacity - 1);
+    return &p_cache->entries[i];
+}
+
+// Doubling the table once it is half full - lock held
+int Cache_Grow(struct Maze_Cache *p_cache)
+{
+    struct Cache_Entry *old = p_cache->entries;
+    unsigned int i, old_capacity = p_cache->capacity;
+
+    if ((p_cache->count * 2) < p_cache->capacity)
+        return 0;
+
+    p_cache->entries = calloc(old_capacity * 2, sizeof(struct Cache_Entry));
+    if (p_cache->entries == NULL)
+    {
+        p_cache->entries = old;
+        return -1;
+    }
+    p_cache->capacity = old_capacity * 2;
+    for (i = 0; i < old_capacity; i++)
+        if (old[i].key.rows != 0)
+            *Cache_Slot(p_cache, &old[i].key) = old[i];
+    free(old);
+    return 0;
+}
+
+// Adding an entry, or the explorations it has to the entry already there - lock held
+// The explorations of a different moves budget replace all the stored ones
+int Cache_Insert(struct Maze_Cache *p_cache, const struct Cache_Entry *p_entry)
+{
+    struct Cache_Entry *p_slot = Cache_Slot(p_cache, &p_entry->key);
+    unsigned int transform;
+
+    if (p_slot->key.rows == 0)
+    {
+        if ((p_cache->count + 1) >= p_cache->capacity) // A table that could not grow is never filled
+            return -1;
+        *p_slot = *p_entry;
+        p_cache->count++;
+        return Cache_Grow(p_cache);
+    }
+    for (transform = 0; transform < 8; transform++)
+        if (p_entry->end_reason[transform] != END_NONE)
+        {
+            if (p_slot->explore_budget != p_entry->explore_budget)
+            {
+                memset(p_slot->end_reason, END_NONE, sizeof(p_slot->end_reason));
+                p_slot->explore_budget = p_entry->explore_budget;
+            }
+            p_slot->explore_moves[transform] = p_entry->explore_moves[transform];
+            p_slot->explore_cells[transform] = p_entry->explore_cells[transform];
+            p_slot->end_reason[transform] = p_entry->end_reason[transform];
+        }
+    return 0;
+}
+
+int Maze_Cache_Setup(struct Maze_Cache *p_cache)
+{
+    p_cache->entries = calloc(CACHE_CAPACITY, sizeof(struct Cache_Entry));
+    if (p_cache->entries == NULL)
+        return -1;
+    p_cache->capacity = CACHE_CAPACITY;
+    p_cache->count = 0;
+    p_cache->queries = 0;
+    p_cache->hits = 0;
+    p_cache->shape_hits = 0;
+    pthread_mutex_init(&p_cache->lock, NULL);
+    return 0;
+}
+
+// Returns the number of entries read, 0 if the file does not exist yet and -1 if it is not a cache
+int Maze_Cache_Load(struct Maze_Cache *p_cache, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    struct Cache_Header header;
+    struct Cache_Entry entry;
+    unsigned int i;
+    int result = 0;
+
+    if (file == NULL)
+        return 0;
+    if ((fread(&header, sizeof(header), 1, file) != 1) || (memcmp(header.magic, CACHE_MAGIC, 4) != 0) ||
+        (header.version != CACHE_VERSION) || (header.entry_size != sizeof(struct Cache_Entry)))
+    {
+        fclose(file);
+        return -1;
+    }
+
+    for (i = 0; (i < header.count) && (result == 0); i++)
+    {
+        if ((fread(&entry, sizeof(entry), 1, file) != 1) || (entry.key.rows == 0))
+            result = -1;
+        else
+            result = Cache_Insert(p_cache, &entry);
+    }
+    fclose(file);
+    return (result == 0) ? (int)header.count : -1;
+}
+
+int Maze_Cache_Save(struct Maze_Cache *p_cache, const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    struct Cache_Header header;
+    unsigned int i;
+
+    if (file == NULL)
+        return -1;
+
+    memcpy(header.magic, CACHE_MAGIC, 4);
+    header.version = CACHE_VERSION;
+    header.entry_size = sizeof(struct Cache_Entry);
+    header.count = p_cache->count;
+    fwrite(&header, sizeof(header), 1, file);
+    for (i = 0; i < p_cache->capacity; i++)
+        if (p_cache->entries[i].key.rows != 0)
+            fwrite(&p_cache->entries[i], sizeof(struct Cache_Entry), 1, file);
+
+    return (fclose(file) != 0) ? -1 : 0;
+}
+
+void Maze_Cache_Close(struct Maze_Cache *p_cache)
+{
+    free(p_cache->entries);
+    p_cache->entries = NULL;
+    pthread_mutex_destroy(&p_cache->lock);
+}
+
+// Same results as Maze_Features, reusing the ones of an equivalent maze when possible
+// Several threads can share the cache
+unsigned int Cached_Features(struct Maze_Cache *p_cache, const struct Maze_Route *p_route, const struct Explore_Budget *p_budget, struct Maze_Stats *p_stats)
+{
+    struct Maze_Key key;
+    struct Cache_Entry entry, *p_slot;
+    unsigned int maze[SIZE][SIZE], dist[SIZE][SIZE];
+    unsigned int transform, r = 0, c = 0, corner, dead_ends, timed, result = CACHE_MISS;
+    int grown;
+
+    // An exploration stopped by a clock could end differently next time
+    timed = (p_budget->max_time_ms != 0) || (p_budget->max_decision_us != 0);
+
+    // Corner of the canonical maze the mouse starts from
+    Maze_Canonical(p_route, &key, &transform);
+    Transform_Point(transform, p_route->rows, p_route->cols, &r, &c);
+    corner = ((r != 0) << 1) | (c != 0);
+
+    pthread_mutex_lock(&p_cache->lock);
+    p_cache->queries++;
+    p_slot = Cache_Slot(p_cache, &key);
+    if (p_slot->key.rows != 0)
+    {
+        entry = *p_slot;
+        result = CACHE_SHAPE;
+        if (!timed && (entry.end_reason[transform] != END_NONE) && (entry.explore_budget == p_budget->max_moves))
+            result = CACHE_HIT;
+    }
+    if (result == CACHE_HIT)
+        p_cache->hits++;
+    else if (result == CACHE_SHAPE)
+        p_cache->shape_hits++;
+    pthread_mutex_unlock(&p_cache->lock);
+
+    if (result == CACHE_HIT)
+    {
+        p_stats->explore_moves = entry.explore_moves[transform];
+        p_stats->explore_cells = entry.explore_cells[transform];
+        p_stats->end_reason = entry.end_reason[transform];
+    }
+    else if (result == CACHE_SHAPE)
+    {
+        Generate_Maze(maze);
+        Generate_Route(maze, p_route);
+        p_stats->end_reason = Explore_To_Destination(maze, p_budget, &p_stats->explore_moves, &p_stats->explore_cells);
+    }
+    else
+    {
+        Maze_Features(p_route, p_budget, p_stats);
+
+        // Features seen from the other corners
+        Generate_Maze(maze);
+        Generate_Route(maze, p_route);
+        Maze_Distances(maze, p_route->rows, p_route->cols, dist);
+        dead_ends = p_stats->dead_ends + (Cell_Openings(maze, p_route->rows, p_route->cols, 0, 0) == 1);
+
+        memset(&entry, 0, sizeof(entry));
+        entry.key = key;
+        entry.loops = p_stats->loops;
+        entry.junctions = p_stats->junctions;
+        entry.branching = p_stats->branching;
+        for (r = 0; r < p_route->rows; r += p_route->rows - 1)
+            for (c = 0; c < p_route->cols; c += p_route->cols - 1)
+            {
+                unsigned int corner_r = r, corner_c = c;
+
+                Transform_Point(transform, p_route->rows, p_route->cols, &corner_r, &corner_c);
+                corner_r = ((corner_r != 0) << 1) | (corner_c != 0);
+                entry.corner_path[corner_r] = (dist[r][c] > 255) ? 255 : dist[r][c];
+                entry.corner_dead_ends[corner_r] = dead_ends - (Cell_Openings(maze, p_route->rows, p_route->cols, r, c) == 1);
+            }
+    }
+
+    if (result != CACHE_MISS)
+    {
+        p_stats->shortest_path = (entry.corner_path[corner] == 255) ? NO_ROUTE : entry.corner_path[corner];
+        p_stats->dead_ends = entry.corner_dead_ends[corner];
+        p_stats->loops = entry.loops;
+        p_stats->junctions = entry.junctions;
+        p_stats->branching = entry.branching;
+    }
+    if (result == CACHE_HIT)
+        return result;
+
+    // Only the exploration of this orientation is added to the stored ones
+    memset(entry.end_reason, END_NONE, sizeof(entry.end_reason));
+    if (!timed)
+    {
+        entry.explore_moves[transform] = p_stats->explore_moves;
+        entry.explore_cells[transform] = p_stats->explore_cells;
+        entry.end_reason[transform] = p_stats->end_reason;
+        entry.explore_budget = p_budget->max_moves;
+    }
+
+    pthread_mutex_lock(&p_cache->lock);
+    grown = Cache_Insert(p_cache, &entry);
+    pthread_mutex_unlock(&p_cache->lock);
+    if (grown != 0)
+        fprintf(stderr, "maze cache: out of memory, results not stored\n");
+
+    return result;
+}
@@ -0,0 +1,87 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#ifndef MAZE_CACHE_H
+#define MAZE_CACHE_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "micromouse.h"
+#include "maze_stats.h"
+
+#define CACHE_MAGIC "MMCC"
+#define CACHE_VERSION 4
+#define CACHE_CAPACITY 4096 // Starting number of slots (power of 2), doubled when half full
+
+// Symmetries - applied in this order
+#define MIRROR_COLS 0b001 // 1 - c becomes cols - 1 - c
+#define MIRROR_ROWS 0b010 // 2 - r becomes rows - 1 - r
+#define TRANSPOSE 0b100   // 4 - r and c are swapped (6x8 becomes 8x6)
+
+// Cache results
+#define CACHE_MISS 0  // Everything computed
+#define CACHE_SHAPE 1 // Equivalent maze found, the exploration of this orientation computed
+#define CACHE_HIT 2   // Same maze found, nothing computed
+
+// Passages of a maze packed one bit per cell (bit r * 8 + c, first row at the bottom)
+struct Maze_Key
+{
+    uint64_t north, east; // Passage to the next row / column
+    uint8_t rows, cols;
+};
+
+// Results of one maze in its canonical orientation
+struct Cache_Entry
+{
+    struct Maze_Key key; // rows = 0 for an empty slot
+    uint8_t loops, junctions;
+    uint16_t branching;
+    uint8_t corner_path[4];      // Shortest path from each corner (bit 1 = top, bit 0 = right)
+    uint8_t corner_dead_ends[4]; // Dead ends when starting from each corner
+    uint8_t explore_cells[8];    // Exploration of each orientation (transform) of the maze
+    uint8_t end_reason[8];       // END_NONE if this orientation has not been explored
+    uint32_t explore_moves[8];
+    uint32_t explore_budget; // Moves budget of all the explorations stored
+};
+
+struct Maze_Cache
+{
+    struct Cache_Entry *entries;
+    unsigned int capacity, count;
+    unsigned long queries, hits, shape_hits; // shape_hits - only the exploration computed
+    pthread_mutex_t lock;
+};
+
+void Maze_Canonical(const struct Maze_Route *p_route, struct Maze_Key *p_key, unsigned int *p_transform);
+int Maze_Cache_Setup(struct Maze_Cache *p_cache);
+int Maze_Cache_Load(struct Maze_Cache *p_cache, const char *path);
+int Maze_Cache_Save(struct Maze_Cache *p_cache, const char *path);
+void Maze_Cache_Close(struct Maze_Cache *p_cache);
+unsigned int Cached_Features(struct Maze_Cache *p_cache, const struct Maze_Route *p_route, const struct Explore_Budget *p_budget, struct Maze_Stats *p_stats);
+
+#endif
@@ -0,0 +1,123 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+// Maze file converter
+// Reads a mazes.txt-like file and writes a binary maze file: a header and one fixed-size record per maze,
+// loaded back with a single read (Maze_Binary_Load). Mazes where two neighbouring cells do not agree on a
+// wall (e.g. East wall on a cell, no West wall on the next one) are reported.
+//
+//   maze_convert <mazes file> <binary file> [--strict]
+//     --strict   mazes with walls not matching are left out
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "micromouse.h"
+#include "maze_io.h"
+
+int main(int argc, char *argv[])
+{
+    struct Maze_Reader *p_reader;
+    struct Maze_Route route;
+    struct Maze_Record record;
+    struct Binary_Header header;
+    FILE *binary_file;
+    unsigned long long offset;
+    unsigned long line;
+    unsigned int row, col, mismatches, strict = 0, count = 0, bad = 0, not_matching = 0;
+    int result;
+
+    if ((argc == 4) && (strcmp(argv[3], "--strict") == 0))
+        strict = 1;
+    else if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s <mazes file> <binary file> [--strict]\n", argv[0]);
+        return 1;
+    }
+
+    p_reader = malloc(sizeof(*p_reader));
+    if (p_reader == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (Maze_Reader_Map(p_reader, argv[1]) != 0)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        free(p_reader);
+        return 1;
+    }
+    binary_file = fopen(argv[2], "wb");
+    if (binary_file == NULL)
+    {
+        fprintf(stderr, "cannot create %s\n", argv[2]);
+        Maze_Reader_Close(p_reader);
+        free(p_reader);
+        return 1;
+    }
+
+    // Count is written once all the mazes have been read
+    memcpy(header.magic, BINARY_MAGIC, 4);
+    header.version = BINARY_VERSION;
+    header.record_size = sizeof(struct Maze_Record);
+    header.count = 0;
+    fwrite(&header, sizeof(header), 1, binary_file);
+
+    while ((result = Maze_Read_Next(p_reader, &route, &offset, &line)) != 0)
+    {
+        if (result < 0)
+        {
+            fprintf(stderr, "%s:%lu: badly written maze\n", argv[1], line);
+            bad++;
+            continue;
+        }
+
+        mismatches = Route_Mismatches(&route, &row, &col);
+        if (mismatches)
+        {
+            fprintf(stderr, "%s:%lu: %u walls not matching, first one in row %u column %u\n", argv[1], line, mismatches, row + 1, col + 1);
+            not_matching++;
+            if (strict)
+                continue;
+        }
+
+        Route_To_Record(&route, offset, line, &record);
+        fwrite(&record, sizeof(record), 1, binary_file);
+        count++;
+    }
+
+    header.count = count;
+    fseek(binary_file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, binary_file);
+
+    printf("%u mazes converted (%u badly written, %u with walls not matching)\n", count, bad, not_matching);
+
+    Maze_Reader_Close(p_reader);
+    free(p_reader);
+    return fclose(binary_file) != 0;
+}
@@ -0,0 +1,488 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+// Maze corpus index
+// Reads a mazes.txt-like file (or a binary maze file from maze_convert) once and writes a fixed-size record
+// of features per maze, the index can then be filtered/sampled without reading the mazes again.
+//
+//   maze_index build <mazes file> <index file> [-j threads] [--moves N] [--time-ms N] [--decision-us N]
+//                    [--cache FILE]
+//   maze_index query <index file> [--path MIN:MAX] [--explore MIN:MAX] [--loops MIN:MAX]
+//                    [--dead-ends MIN:MAX] [--end REASON] [--sample N] [--seed S]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "micromouse.h"
+#include "maze_io.h"
+#include "maze_stats.h"
+#include "maze_cache.h"
+
+#define INDEX_MAGIC "MMIX"
+#define INDEX_VERSION 2
+#define INDEX_BATCH 8192 // Mazes read before the threads compute their features
+#define MAX_THREADS 64
+
+// Record Flags
+#define INDEX_BAD 0b01 // 1 - Maze could not be read
+
+struct Index_Header
+{
+    char magic[4];
+    uint32_t version, record_size, count;
+};
+
+// One record per maze in the same order as the mazes file (native byte order)
+struct Index_Record
+{
+    uint64_t offset;        // Position of the maze in the mazes file
+    uint32_t line;          // Line of the maze in the mazes file
+    uint16_t branching;     // Average extra choices per cell that is not a dead end (x100)
+    uint16_t explore_moves; // Mouse moves until destination
+    uint8_t shape; // rows << 4 | cols
+    uint8_t shortest_path, loops, dead_ends, junctions;
+    uint8_t explore_cells; // Cells found by the mouse until destination
+    uint8_t end_reason;    // Why the exploration stopped (END_COMPLETE = destination reached)
+    uint8_t flags;
+};
+
+struct Index_Job
+{
+    struct Maze_Route route;
+    unsigned long long offset;
+    unsigned long line;
+    int read_result;
+    struct Index_Record record;
+};
+
+struct Index_Worker
+{
+    pthread_t thread;
+    const struct Explore_Budget *p_budget;
+    struct Maze_Cache *p_cache; // NULL when every maze is computed
+    struct Index_Job *jobs;
+    unsigned int first, count, step;
+};
+
+void Index_Record_Fill(struct Index_Job *p_job, const struct Explore_Budget *p_budget, struct Maze_Cache *p_cache)
+{
+    struct Maze_Stats stats;
+    struct Index_Record *p_record = &p_job->record;
+
+    memset(p_record, 0, sizeof(*p_record));
+    p_record->offset = p_job->offset;
+    p_record->line = p_job->line;
+
+    if (p_job->read_result != 1)
+    {
+        p_record->flags = INDEX_BAD;
+        return;
+    }
+
+    if (p_cache != NULL)
+        Cached_Features(p_cache, &p_job->route, p_budget, &stats);
+    else
+        Maze_Features(&p_job->route, p_budget, &stats);
+
+    p_record->shape = (p_job->route.rows << 4) | p_job->route.cols;
+    p_record->shortest_path = (stats.shortest_path > 255) ? 255 : stats.shortest_path;
+    p_record->loops = stats.loops;
+    p_record->dead_ends = stats.dead_ends;
+    p_record->junctions = stats.junctions;
+    p_record->branching = stats.branching;
+    p_record->explore_moves = (stats.explore_moves > 65535) ? 65535 : stats.explore_moves;
+    p_record->explore_cells = stats.explore_cells;
+    p_record->end_reason = stats.end_reason;
+}
+
+void *Index_Worker_Run(void *p_arg)
+{
+    struct Index_Worker *p_worker = p_arg;
+    unsigned int i;
+
+    for (i = p_worker->first; i < p_worker->count; i += p_worker->step)
+        Index_Record_Fill(&p_worker->jobs[i], p_worker->p_budget, p_worker->p_cache);
+
+    return NULL;
+}
+
+// Computing the features of every maze, the records are written in the same order as the mazes
+int Index_Write(const char *mazes_path, FILE *index_file, struct Maze_Reader *p_reader, const struct Maze_Binary *p_binary,
+                struct Index_Job *jobs, unsigned int threads, const struct Explore_Budget *p_budget, struct Maze_Cache *p_cache)
+{
+    struct Index_Worker workers[MAX_THREADS];
+    struct Index_Header header;
+    unsigned int i, count, started, next = 0, total = 0, bad = 0, ends[END_LAST + 1] = {0};
+    int result = 1;
+
+    // Count is written once all the mazes have been read
+    memcpy(header.magic, INDEX_MAGIC, 4);
+    header.version = INDEX_VERSION;
+    header.record_size = sizeof(struct Index_Record);
+    header.count = 0;
+    fwrite(&header, sizeof(header), 1, index_file);
+
+    while (result != 0)
+    {
+        // Reading a batch of mazes
+        for (count = 0; count < INDEX_BATCH; count++)
+        {
+            if (p_binary->data != NULL)
+            {
+                result = (next < p_binary->count);
+                if (result)
+                {
+                    Record_To_Route(&p_binary->records[next], &jobs[count].route);
+                    jobs[count].offset = p_binary->records[next].offset;
+                    jobs[count].line = p_binary->records[next].line;
+                    next++;
+                }
+            }
+            else
+                result = Maze_Read_Next(p_reader, &jobs[count].route, &jobs[count].offset, &jobs[count].line);
+            if (result == 0)
+                break;
+            jobs[count].read_result = result;
+        }
+
+        // Computing the features in parallel
+        for (i = 0, started = 0; i < threads; i++)
+        {
+            workers[i].p_budget = p_budget;
+            workers[i].p_cache = p_cache;
+            workers[i].jobs = jobs;
+            workers[i].first = i;
+            workers[i].count = count;
+            workers[i].step = threads;
+            if ((started == i) && (pthread_create(&workers[i].thread, NULL, Index_Worker_Run, &workers[i]) == 0))
+                started++;
+        }
+        // The mazes of the threads that could not start are computed here
+        for (i = started; i < threads; i++)
+            Index_Worker_Run(&workers[i]);
+        for (i = 0; i < started; i++)
+            pthread_join(workers[i].thread, NULL);
+        if ((started < threads) && (started > 0))
+        {
+            fprintf(stderr, "only %u of %u threads started\n", started, threads);
+            threads = started;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            fwrite(&jobs[i].record, sizeof(struct Index_Record), 1, index_file);
+            if ((jobs[i].record.flags & INDEX_BAD) == INDEX_BAD)
+            {
+                fprintf(stderr, "%s:%lu: badly written maze\n", mazes_path, jobs[i].line);
+                bad++;
+            }
+            else
+                ends[jobs[i].record.end_reason]++;
+        }
+        total += count;
+    }
+
+    header.count = total;
+    fseek(index_file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, index_file);
+
+    printf("%u mazes indexed (%u badly written)\n", total, bad);
+    for (i = END_COMPLETE; i <= END_LAST; i++)
+        printf("end = %s\t%u\n", End_Reason_Name(i), ends[i]);
+    if (p_cache != NULL)
+        printf("cache hits = %lu of %lu\tturned/mirrored = %lu (explored again)\tmisses = %lu\t%u mazes stored\n", p_cache->hits,
+               p_cache->queries, p_cache->shape_hits, p_cache->queries - p_cache->hits - p_cache->shape_hits, p_cache->count);
+
+    return ferror(index_file) != 0;
+}
+
+int Index_Build(const char *mazes_path, const char *index_path, unsigned int threads, const struct Explore_Budget *p_budget,
+                struct Maze_Cache *p_cache)
+{
+    FILE *index_file;
+    struct Maze_Reader *p_reader;
+    struct Maze_Binary binary = {NULL, NULL, 0};
+    struct Index_Job *jobs;
+    unsigned int loaded = 1;
+    int result = 1;
+
+    p_reader = malloc(sizeof(*p_reader));
+    jobs = malloc(INDEX_BATCH * sizeof(*jobs));
+    if (p_reader != NULL)
+        Maze_Reader_Setup(p_reader, NULL);
+
+    if ((p_reader == NULL) || (jobs == NULL))
+        fprintf(stderr, "out of memory\n");
+    else if (Maze_Reader_Map(p_reader, mazes_path) != 0)
+        fprintf(stderr, "cannot open %s\n", mazes_path);
+    else
+    {
+        // Binary maze files are loaded at once instead
+        if ((p_reader->len >= 4) && (memcmp(p_reader->data, BINARY_MAGIC, 4) == 0))
+        {
+            Maze_Reader_Close(p_reader);
+            loaded = (Maze_Binary_Load(mazes_path, &binary) == 0);
+            if (!loaded)
+                fprintf(stderr, "%s is not a valid binary maze file\n", mazes_path);
+        }
+
+        index_file = loaded ? fopen(index_path, "wb") : NULL;
+        if (loaded && (index_file == NULL))
+            fprintf(stderr, "cannot create %s\n", index_path);
+        if (index_file != NULL)
+        {
+            result = Index_Write(mazes_path, index_file, p_reader, &binary, jobs, threads, p_budget, p_cache);
+            if (fclose(index_file) != 0)
+                result = 1;
+        }
+    }
+
+    // Single exit, whatever has been opened is released
+    if (p_reader != NULL)
+        Maze_Reader_Close(p_reader);
+    Maze_Binary_Close(&binary);
+    free(jobs);
+    free(p_reader);
+    return result;
+}
+
+// Reading a MIN:MAX range - a single number sets both
+void Read_Range(const char *text, unsigned int range[2])
+{
+    const char *colon = strchr(text, ':');
+
+    range[0] = strtoul(text, NULL, 10);
+    range[1] = colon ? strtoul(colon + 1, NULL, 10) : range[0];
+}
+
+unsigned int In_Range(unsigned int value, const unsigned int range[2])
+{
+    return (value >= range[0]) && (value <= range[1]);
+}
+
+void Print_Record(unsigned int number, const struct Index_Record *p_record)
+{
+    printf("%u\t%u\t%llu\t%ux%u\t%u\t%u\t%u\t%u\t%u.%02u\t%u\t%u\t%s\n", number, (unsigned int)p_record->line,
+           (unsigned long long)p_record->offset, p_record->shape & 0x0F, p_record->shape >> 4, p_record->shortest_path, p_record->loops,
+           p_record->dead_ends, p_record->junctions, p_record->branching / 100, p_record->branching % 100,
+           p_record->explore_moves, p_record->explore_cells, End_Reason_Name(p_record->end_reason));
+}
+
+int Index_Query(const char *index_path, int argc, char *argv[])
+{
+    FILE *index_file;
+    struct Index_Header header;
+    struct Index_Record record, *samples = NULL;
+    unsigned int *sample_numbers = NULL;
+    unsigned int path[2] = {0, 255}, explore[2] = {0, 65535}, loops[2] = {0, 255}, dead_ends[2] = {0, 255};
+    unsigned int i, j, sample = 0, seed = 1, matches = 0, end_reason = END_NONE, explore_given = 0;
+    int a;
+
+    for (a = 0; a < argc; a += 2)
+    {
+        if (a + 1 == argc)
+        {
+            fprintf(stderr, "missing value for %s\n", argv[a]);
+            return 1;
+        }
+        if (strcmp(argv[a], "--path") == 0)
+            Read_Range(argv[a + 1], path);
+        else if (strcmp(argv[a], "--explore") == 0)
+        {
+            Read_Range(argv[a + 1], explore);
+            explore_given = 1;
+        }
+        else if (strcmp(argv[a], "--loops") == 0)
+            Read_Range(argv[a + 1], loops);
+        else if (strcmp(argv[a], "--dead-ends") == 0)
+            Read_Range(argv[a + 1], dead_ends);
+        else if (strcmp(argv[a], "--end") == 0)
+        {
+            for (end_reason = END_COMPLETE; end_reason <= END_LAST; end_reason++)
+                if (strcmp(argv[a + 1], End_Reason_Name(end_reason)) == 0)
+                    break;
+            if (end_reason > END_LAST)
+            {
+                fprintf(stderr, "unknown end reason %s\n", argv[a + 1]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[a], "--sample") == 0)
+            sample = strtoul(argv[a + 1], NULL, 10);
+        else if (strcmp(argv[a], "--seed") == 0)
+            seed = strtoul(argv[a + 1], NULL, 10);
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[a]);
+            return 1;
+        }
+    }
+
+    index_file = fopen(index_path, "rb");
+    if (index_file == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", index_path);
+        return 1;
+    }
+    if ((fread(&header, sizeof(header), 1, index_file) != 1) || (memcmp(header.magic, INDEX_MAGIC, 4) != 0) ||
+        (header.version != INDEX_VERSION) || (header.record_size != sizeof(struct Index_Record)))
+    {
+        fprintf(stderr, "%s is not a maze index\n", index_path);
+        fclose(index_file);
+        return 1;
+    }
+
+    if (sample)
+    {
+        samples = malloc(sample * sizeof(*samples));
+        sample_numbers = malloc(sample * sizeof(*sample_numbers));
+        if ((samples == NULL) || (sample_numbers == NULL))
+        {
+            fprintf(stderr, "out of memory\n");
+            free(samples);
+            free(sample_numbers);
+            fclose(index_file);
+            return 1;
+        }
+        srand(seed);
+    }
+
+    printf("maze\tline\toffset\tsize\tpath\tloops\tdead_ends\tjunctions\tbranching\texplore_moves\texplore_cells\tend\n");
+    for (i = 0; (i < header.count) && (fread(&record, sizeof(record), 1, index_file) == 1); i++)
+    {
+        if (((record.flags & INDEX_BAD) == INDEX_BAD) || !In_Range(record.shortest_path, path) ||
+            !In_Range(record.explore_moves, explore) || !In_Range(record.loops, loops) || !In_Range(record.dead_ends, dead_ends) ||
+            ((end_reason != END_NONE) && (record.end_reason != end_reason)) ||
+            (explore_given && (record.end_reason != END_COMPLETE))) // Lost mazes have no exploration length
+            continue;
+
+        matches++;
+        if (!sample)
+            Print_Record(i, &record);
+        else
+        {
+            // Keeping an even sample of all the matching mazes (reservoir sampling)
+            j = (matches <= sample) ? (matches - 1) : (unsigned int)(((unsigned long long)rand() * RAND_MAX + rand()) % matches);
+            if (j < sample)
+            {
+                samples[j] = record;
+                sample_numbers[j] = i;
+            }
+        }
+    }
+    fclose(index_file);
+
+    for (j = 0; (j < sample) && (j < matches); j++)
+        Print_Record(sample_numbers[j], &samples[j]);
+    fprintf(stderr, "%u of %u mazes match\n", matches, header.count);
+
+    free(samples);
+    free(sample_numbers);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct Explore_Budget budget = {MAX_EXPLORE_MOVES, 0, 0};
+    struct Maze_Cache cache;
+    const char *cache_path = NULL;
+    unsigned int threads = 1;
+    int a, result;
+
+#ifdef _SC_NPROCESSORS_ONLN
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    if ((argc >= 4) && (strcmp(argv[1], "build") == 0))
+    {
+        for (a = 4; a + 1 < argc; a += 2)
+        {
+            if (strcmp(argv[a], "-j") == 0)
+                threads = strtoul(argv[a + 1], NULL, 10);
+            else if (strcmp(argv[a], "--moves") == 0)
+                budget.max_moves = strtoul(argv[a + 1], NULL, 10);
+            else if (strcmp(argv[a], "--time-ms") == 0)
+                budget.max_time_ms = strtoul(argv[a + 1], NULL, 10);
+            else if (strcmp(argv[a], "--decision-us") == 0)
+                budget.max_decision_us = strtoul(argv[a + 1], NULL, 10);
+            else if (strcmp(argv[a], "--cache") == 0)
+                cache_path = argv[a + 1];
+            else
+                break;
+        }
+        if (a != argc)
+        {
+            fprintf(stderr, "usage: %s build <mazes file> <index file> [-j threads] [--moves N] [--time-ms N] [--decision-us N] [--cache FILE]\n", argv[0]);
+            return 1;
+        }
+        // A mouse going round in circles would never stop
+        if ((budget.max_moves == 0) && (budget.max_time_ms == 0))
+        {
+            fprintf(stderr, "--moves 0 (no limit) needs --time-ms\n");
+            return 1;
+        }
+        if (threads < 1)
+            threads = 1;
+        if (threads > MAX_THREADS)
+            threads = MAX_THREADS;
+        if (cache_path == NULL)
+            return Index_Build(argv[2], argv[3], threads, &budget, NULL);
+
+        // Results of the mazes already seen in previous builds
+        if (Maze_Cache_Setup(&cache) != 0)
+        {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        if (Maze_Cache_Load(&cache, cache_path) < 0)
+        {
+            fprintf(stderr, "%s is not a maze cache\n", cache_path);
+            Maze_Cache_Close(&cache);
+            return 1;
+        }
+        result = Index_Build(argv[2], argv[3], threads, &budget, &cache);
+        if ((result == 0) && (Maze_Cache_Save(&cache, cache_path) != 0))
+        {
+            fprintf(stderr, "cannot write %s\n", cache_path);
+            result = 1;
+        }
+        Maze_Cache_Close(&cache);
+        return result;
+    }
+
+    if ((argc >= 3) && (strcmp(argv[1], "query") == 0))
+        return Index_Query(argv[2], argc - 3, argv + 3);
+
+    fprintf(stderr, "usage: %s build <mazes file> <index file> [-j threads] [--moves N] [--time-ms N] [--decision-us N] [--cache FILE]\n", argv[0]);
+    fprintf(stderr, "       %s query <index file> [--path MIN:MAX] [--explore MIN:MAX] [--loops MIN:MAX]\n", argv[0]);
+    fprintf(stderr, "                [--dead-ends MIN:MAX] [--end REASON] [--sample N] [--seed S]\n");
+    return 1;
+}
@@ -0,0 +1,542 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "maze_io.h"
+
+void Maze_Reader_Setup(struct Maze_Reader *p_reader, FILE *file)
+{
+    p_reader->file = file;
+    p_reader->data = p_reader->buffer;
+    p_reader->pos = 0;
+    p_reader->len = 0;
+    p_reader->offset = 0;
+    p_reader->line = 1;
+    p_reader->map = NULL;
+    p_reader->map_size = 0;
+}
+
+// Reading text already in memory - it is not copied and must stay there until the end of the reading
+void Maze_Reader_Memory(struct Maze_Reader *p_reader, const void *data, size_t size)
+{
+    Maze_Reader_Setup(p_reader, NULL);
+    if (data != NULL)
+        p_reader->data = data;
+    p_reader->len = (data != NULL) ? size : 0;
+}
+
+// Reading from the whole file in memory - mapped, so nothing is copied
+// On Windows the file is read at once instead
+int Maze_Reader_Map(struct Maze_Reader *p_reader, const char *path)
+{
+    void *map = NULL;
+    size_t size;
+
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    long file_size;
+
+    if (file == NULL)
+        return -1;
+    fseek(file, 0, SEEK_END);
+    file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    size = (file_size > 0) ? (size_t)file_size : 0;
+    if (size > 0)
+    {
+        map = malloc(size);
+        if ((map == NULL) || (fread(map, 1, size, file) != size))
+        {
+            free(map);
+            fclose(file);
+            return -1;
+        }
+    }
+    fclose(file);
+#else
+    struct stat file_stat;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &file_stat) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    size = file_stat.st_size;
+    if (size > 0)
+    {
+        map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED)
+        {
+            close(fd);
+            return -1;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(map, size, MADV_SEQUENTIAL);
+#endif
+    }
+    close(fd);
+#endif
+
+    Maze_Reader_Memory(p_reader, map, size);
+    p_reader->map = map;
+    p_reader->map_size = size;
+    return 0;
+}
+
+void Maze_Reader_Close(struct Maze_Reader *p_reader)
+{
+    if (p_reader->map != NULL)
+    {
+#ifdef _WIN32
+        free(p_reader->map);
+#else
+        munmap(p_reader->map, p_reader->map_size);
+#endif
+    }
+    p_reader->map = NULL;
+    p_reader->data = p_reader->buffer;
+    p_reader->pos = 0;
+    p_reader->len = 0;
+}
+
+// Next character of the file without reading it - EOF at the end
+int Reader_Peek(struct Maze_Reader *p_reader)
+{
+    if (p_reader->pos == p_reader->len)
+    {
+        if (p_reader->file == NULL) // Whole file already in memory
+            return EOF;
+        p_reader->len = fread(p_reader->buffer, 1, READER_BUFFER, p_reader->file);
+        p_reader->pos = 0;
+        if (p_reader->len == 0)
+            return EOF;
+    }
+
+    return p_reader->data[p_reader->pos];
+}
+
+int Reader_Get(struct Maze_Reader *p_reader)
+{
+    int ch = Reader_Peek(p_reader);
+
+    if (ch != EOF)
+    {
+        p_reader->pos += 1;
+        p_reader->offset += 1;
+        if (ch == '\n')
+            p_reader->line += 1;
+    }
+
+    return ch;
+}
+
+// Moving to the next c1 or c2 in memory (or to the end of it), counting the lines on the way
+void Reader_Skip_To(struct Maze_Reader *p_reader, unsigned char c1, unsigned char c2)
+{
+    const unsigned char *start = p_reader->data + p_reader->pos, *p = start, *end = p_reader->data + p_reader->len;
+    unsigned long lines = 0;
+    unsigned int stop = 0;
+
+#ifdef __SSE2__
+    // 16 characters at a time
+    const __m128i find1 = _mm_set1_epi8(c1), find2 = _mm_set1_epi8(c2), new_line = _mm_set1_epi8('\n');
+    __m128i chunk;
+    unsigned int new_lines;
+
+    while (!stop && (p + 16 <= end))
+    {
+        chunk = _mm_loadu_si128((const __m128i *)p);
+        stop = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, find1), _mm_cmpeq_epi8(chunk, find2)));
+        new_lines = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, new_line));
+        if (stop)
+        {
+            new_lines &= (stop & -stop) - 1; // Only the lines before the character found
+            p += __builtin_ctz(stop);
+        }
+        else
+            p += 16;
+        lines += __builtin_popcount(new_lines);
+    }
+#endif
+
+    while (!stop && (p < end) && (*p != c1) && (*p != c2))
+    {
+        if (*p == '\n')
+            lines++;
+        p++;
+    }
+
+    p_reader->pos += p - start;
+    p_reader->offset += p - start;
+    p_reader->line += lines;
+}
+
+// Digits and commas of the next 16 characters (or less at the end), one bit per character
+// Returns how many characters are digits, commas or spaces before anything else
+unsigned int Reader_Masks(const unsigned char *p, const unsigned char *end, unsigned int *p_digits, unsigned int *p_commas)
+{
+    unsigned int i, clean;
+
+#ifdef __SSE2__
+    if (p + 16 <= end)
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        const __m128i number = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+        unsigned int spaces;
+
+        // A character is a digit if it is between '0' and '9' once '0' is taken away (unsigned)
+        *p_digits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(number, _mm_set1_epi8(9)), number));
+        *p_commas = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')));
+        spaces = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')));
+        clean = __builtin_ctz(~(*p_digits | *p_commas | spaces) | 0x10000);
+        *p_digits &= (1u << clean) - 1;
+        *p_commas &= (1u << clean) - 1;
+        return clean;
+    }
+#endif
+
+    *p_digits = 0;
+    *p_commas = 0;
+    for (i = 0; (i < 16) && (p + i < end); i++)
+    {
+        if ((p[i] >= '0') && (p[i] <= '9'))
+            *p_digits |= 1u << i;
+        else if (p[i] == ',')
+            *p_commas |= 1u << i;
+        else if (p[i] != ' ')
+            break;
+    }
+    clean = i;
+    return clean;
+}
+
+// Values of a row that are followed by a comma, read straight from memory
+// Stops at anything unusual (and before the last value) - the rest is left to Maze_Read_Next
+// Returns the number of values in the row so far
+unsigned int Row_Values(struct Maze_Reader *p_reader, struct Maze_Route *p_route, unsigned int col)
+{
+    const unsigned char *start = p_reader->data + p_reader->pos, *p = start, *end = p_reader->data + p_reader->len;
+    unsigned int digits, commas, number, first, value, used, i, done = 0;
+
+    while (!done && (p_route->rows < SIZE))
+    {
+        Reader_Masks(p, end, &digits, &commas);
+        used = 0;
+
+        // Every comma closes a value
+        while (!done && commas)
+        {
+            number = digits & ((commas & -commas) - 1) & ~((1u << used) - 1);
+            first = number ? __builtin_ctz(number) : 0;
+            number >>= first;
+
+            // One to three digits next to each other
+            if ((number == 0) || (number > 0b111) || ((number & (number + 1)) != 0) || (col >= SIZE))
+                done = 1;
+            else
+            {
+                for (value = 0, i = first; number; i++, number >>= 1)
+                    value = value * 10 + (p[i] - '0');
+                if (value > BITS)
+                    done = 1;
+                else
+                {
+                    p_route->cells[p_route->rows][col++] = value;
+                    used = __builtin_ctz(commas) + 1;
+                    commas &= commas - 1;
+                }
+            }
+        }
+
+        if (used == 0)
+            done = 1;
+        p += used;
+    }
+
+    p_reader->pos += p - start;
+    p_reader->offset += p - start;
+    return col;
+}
+
+// Reading the next maze of the file
+// Returns 1 if a maze has been read, 0 at the end of the file and -1 if the maze is badly written (it is skipped)
+// Rows are written as {6, 7, 3, ...}, a maze ends with the first row not followed by a comma
+int Maze_Read_Next(struct Maze_Reader *p_reader, struct Maze_Route *p_route, unsigned long long *p_offset, unsigned long *p_line)
+{
+    unsigned int in_row = 0, in_number = 0, number_done = 0, bad = 0;
+    unsigned int value = 0, col = 0;
+    int ch;
+
+    p_route->rows = 0;
+    p_route->cols = 0;
+
+    while (1)
+    {
+        // Text outside of the mazes is ignored
+        if (!in_row && (p_route->rows == 0))
+            Reader_Skip_To(p_reader, '{', '/');
+
+        ch = Reader_Peek(p_reader);
+
+        if (ch == EOF)
+        {
+            if ((p_route->rows == 0) && !in_row)
+                return 0;
+            if (in_row)
+                bad = 1; // Maze cut by the end of the file
+            break;
+        }
+
+        // Comments - a section header also closes the current maze
+        if (ch == '/')
+        {
+            if (!in_row && (p_route->rows > 0))
+                break;
+            Reader_Get(p_reader);
+            if (Reader_Peek(p_reader) != '/')
+                bad = 1;
+            do
+                Reader_Skip_To(p_reader, '\n', '\n');
+            while (((ch = Reader_Peek(p_reader)) != EOF) && (ch != '\n'));
+            continue;
+        }
+
+        Reader_Get(p_reader);
+
+        // Text outside of the mazes is ignored
+        if (!in_row && (p_route->rows == 0) && (ch != '{'))
+            continue;
+
+        if ((ch >= '0') && (ch <= '9'))
+        {
+            if (!in_row || number_done)
+                bad = 1;
+            value = value * 10 + (ch - '0');
+            if (value > BITS)
+                value = BITS + 1; // Keeping the value from overflowing
+            in_number = 1;
+        }
+        else if ((ch == ',') || (ch == '}'))
+        {
+            if (in_row && in_number)
+            {
+                // Storing the cell value
+                if ((value > BITS) || (col >= SIZE) || (p_route->rows >= SIZE))
+                    bad = 1;
+                else
+                    p_route->cells[p_route->rows][col] = value;
+                col++;
+            }
+            else if (in_row)
+                bad = 1; // Empty value
+            value = 0;
+            in_number = number_done = 0;
+
+            if ((ch == '}') && in_row)
+            {
+                // All rows must be as long as the first one
+                if (p_route->rows == 0)
+                    p_route->cols = col;
+                else if (col != p_route->cols)
+                    bad = 1;
+                p_route->rows += 1;
+                in_row = 0;
+
+                // Looking for a following row
+                while (((ch = Reader_Peek(p_reader)) == ' ') || (ch == '\t') || (ch == '\r') || (ch == '\n'))
+                    Reader_Get(p_reader);
+                if (ch != ',')
+                    break;
+                Reader_Get(p_reader);
+            }
+        }
+        else if (ch == '{')
+        {
+            // Opening brace of the whole maze - {{...}, {...}}
+            if (in_row && (col == 0) && !in_number)
+                continue;
+            if (in_row)
+                bad = 1;
+
+            if (p_route->rows == 0)
+            {
+                *p_offset = p_reader->offset - 1;
+                *p_line = p_reader->line;
+            }
+            in_row = 1;
+            col = bad ? 0 : Row_Values(p_reader, p_route, 0);
+        }
+        else if ((ch == ' ') || (ch == '\t') || (ch == '\r') || (ch == '\n'))
+        {
+            if (in_number)
+                number_done = 1;
+        }
+        else if (ch != ';')
+            bad = 1;
+    }
+
+    // The mouse only knows 6x8 and 8x6 mazes
+    if ((p_route->rows * p_route->cols != TOT_CELLS) || (p_route->rows > SIZE) || (p_route->cols > SIZE))
+        bad = 1;
+
+    return bad ? -1 : 1;
+}
+
+// Number of walls written differently by two neighbouring cells (e.g. East wall but no West wall on the next cell)
+// The first one is given as row/column of the cell as written in the file
+unsigned int Route_Mismatches(const struct Maze_Route *p_route, unsigned int *p_row, unsigned int *p_col)
+{
+    unsigned int r, c, mismatches = 0;
+
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+        {
+            // East side against West side of the next cell
+            if ((c < (p_route->cols - 1)) &&
+                (((p_route->cells[r][c] & EAST_WALL) == EAST_WALL) != ((p_route->cells[r][c + 1] & WEST_WALL) == WEST_WALL)))
+            {
+                if (mismatches++ == 0)
+                {
+                    *p_row = r;
+                    *p_col = c;
+                }
+            }
+            // South side against North side of the row below (rows are written from the top)
+            if ((r < (p_route->rows - 1)) &&
+                (((p_route->cells[r][c] & SOUTH_WALL) == SOUTH_WALL) != ((p_route->cells[r + 1][c] & NORTH_WALL) == NORTH_WALL)))
+            {
+                if (mismatches++ == 0)
+                {
+                    *p_row = r;
+                    *p_col = c;
+                }
+            }
+        }
+
+    return mismatches;
+}
+
+void Route_To_Record(const struct Maze_Route *p_route, unsigned long long offset, unsigned long line, struct Maze_Record *p_record)
+{
+    unsigned int r, c;
+
+    memset(p_record, 0, sizeof(*p_record));
+    p_record->offset = offset;
+    p_record->line = line;
+    p_record->rows = p_route->rows;
+    p_record->cols = p_route->cols;
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+            p_record->cells[r][c] = p_route->cells[r][c];
+}
+
+void Record_To_Route(const struct Maze_Record *p_record, struct Maze_Route *p_route)
+{
+    unsigned int r, c;
+
+    p_route->rows = p_record->rows;
+    p_route->cols = p_record->cols;
+    for (r = 0; r < p_record->rows; r++)
+        for (c = 0; c < p_record->cols; c++)
+            p_route->cells[r][c] = p_record->cells[r][c];
+}
+
+// Loading a binary maze file with a single read
+// Returns 0 if the file has been loaded, -1 if it cannot be read or is not a binary maze file
+int Maze_Binary_Load(const char *path, struct Maze_Binary *p_binary)
+{
+    FILE *file = fopen(path, "rb");
+    const struct Binary_Header *p_header;
+    unsigned int i;
+    long size;
+
+    p_binary->data = NULL;
+    p_binary->records = NULL;
+    p_binary->count = 0;
+    if (file == NULL)
+        return -1;
+
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size >= (long)sizeof(struct Binary_Header))
+        p_binary->data = malloc(size);
+    if ((p_binary->data == NULL) || (fread(p_binary->data, 1, size, file) != (size_t)size))
+    {
+        fclose(file);
+        Maze_Binary_Close(p_binary);
+        return -1;
+    }
+    fclose(file);
+
+    p_header = p_binary->data;
+    if ((memcmp(p_header->magic, BINARY_MAGIC, 4) != 0) || (p_header->version != BINARY_VERSION) ||
+        (p_header->record_size != sizeof(struct Maze_Record)) ||
+        ((unsigned long)size != sizeof(struct Binary_Header) + (unsigned long)p_header->count * sizeof(struct Maze_Record)))
+    {
+        Maze_Binary_Close(p_binary);
+        return -1;
+    }
+    p_binary->records = (const struct Maze_Record *)(p_header + 1);
+    p_binary->count = p_header->count;
+
+    // Records are used as they are - checking they describe a maze the mouse knows
+    for (i = 0; i < p_binary->count; i++)
+        if ((p_binary->records[i].rows > SIZE) || (p_binary->records[i].cols > SIZE) ||
+            (p_binary->records[i].rows * p_binary->records[i].cols != TOT_CELLS))
+        {
+            Maze_Binary_Close(p_binary);
+            return -1;
+        }
+
+    return 0;
+}
+
+void Maze_Binary_Close(struct Maze_Binary *p_binary)
+{
+    free(p_binary->data);
+    p_binary->data = NULL;
+    p_binary->records = NULL;
+    p_binary->count = 0;
+}
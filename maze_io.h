@@ -0,0 +1,90 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#ifndef MAZE_IO_H
+#define MAZE_IO_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "micromouse.h"
+
+#ifndef READER_BUFFER
+#define READER_BUFFER 65536 // Bytes read from the file at once - the fuzz harness uses a tiny one
+#endif
+#define BINARY_MAGIC "MMZB"
+#define BINARY_VERSION 1
+
+// Reading mazes.txt one maze at a time, from a stream or from the whole file in memory
+struct Maze_Reader
+{
+    FILE *file; // NULL when the whole file is in memory
+    unsigned char buffer[READER_BUFFER];
+    const unsigned char *data; // buffer, or the whole text in memory
+    size_t pos, len;
+    unsigned long long offset; // Bytes read since the start of the file
+    unsigned long line;        // Current line in the file
+    void *map;                 // Mapped file - NULL if none
+    size_t map_size;
+};
+
+// Binary maze file - header followed by fixed-size records (native byte order)
+struct Binary_Header
+{
+    char magic[4];
+    uint32_t version, record_size, count;
+};
+
+struct Maze_Record
+{
+    uint64_t offset; // Position of the maze in the text file it comes from
+    uint32_t line;   // Line of the maze in the text file it comes from
+    uint8_t rows, cols;
+    uint8_t cells[SIZE][SIZE]; // Written from the top row as in Maze_Route
+    uint8_t padding[2];
+};
+
+struct Maze_Binary
+{
+    void *data; // Whole file
+    const struct Maze_Record *records;
+    unsigned int count;
+};
+
+void Maze_Reader_Setup(struct Maze_Reader *p_reader, FILE *file);
+void Maze_Reader_Memory(struct Maze_Reader *p_reader, const void *data, size_t size);
+int Maze_Reader_Map(struct Maze_Reader *p_reader, const char *path);
+void Maze_Reader_Close(struct Maze_Reader *p_reader);
+int Maze_Read_Next(struct Maze_Reader *p_reader, struct Maze_Route *p_route, unsigned long long *p_offset, unsigned long *p_line);
+unsigned int Route_Mismatches(const struct Maze_Route *p_route, unsigned int *p_row, unsigned int *p_col);
+void Route_To_Record(const struct Maze_Route *p_route, unsigned long long offset, unsigned long line, struct Maze_Record *p_record);
+void Record_To_Route(const struct Maze_Record *p_record, struct Maze_Route *p_route);
+int Maze_Binary_Load(const char *path, struct Maze_Binary *p_binary);
+void Maze_Binary_Close(struct Maze_Binary *p_binary);
+
+#endif
@@ -0,0 +1,205 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#include "maze_stats.h"
+
+// Number of ways out of a cell inside the maze
+unsigned int Cell_Openings(unsigned int maze[SIZE][SIZE], unsigned int rows, unsigned int cols, unsigned int r, unsigned int c)
+{
+    unsigned int openings = 0;
+
+    if (((maze[r][c] & NORTH_WALL) != NORTH_WALL) && (r < (rows - 1)))
+        openings++;
+    if (((maze[r][c] & EAST_WALL) != EAST_WALL) && (c < (cols - 1)))
+        openings++;
+    if (((maze[r][c] & SOUTH_WALL) != SOUTH_WALL) && (r != 0))
+        openings++;
+    if (((maze[r][c] & WEST_WALL) != WEST_WALL) && (c != 0))
+        openings++;
+
+    return openings;
+}
+
+// Number of moves from every cell to the destination square - Flood Fill from destination
+void Maze_Distances(unsigned int maze[SIZE][SIZE], unsigned int rows, unsigned int cols, unsigned int dist[SIZE][SIZE])
+{
+    unsigned int queue[SIZE * SIZE], head = 0, tail = 0;
+    unsigned int r, c;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            dist[r][c] = NO_ROUTE;
+
+    // Destination is the 2x2 square in the centre
+    for (r = (rows / 2) - 1; r <= (rows / 2); r++)
+        for (c = (cols / 2) - 1; c <= (cols / 2); c++)
+        {
+            dist[r][c] = 0;
+            queue[tail++] = r * SIZE + c;
+        }
+
+    while (head != tail)
+    {
+        r = queue[head] / SIZE;
+        c = queue[head] % SIZE;
+        head++;
+
+        if (((maze[r][c] & NORTH_WALL) != NORTH_WALL) && (r < (rows - 1)) && (dist[r + 1][c] == NO_ROUTE))
+        {
+            dist[r + 1][c] = dist[r][c] + 1;
+            queue[tail++] = (r + 1) * SIZE + c;
+        }
+        if (((maze[r][c] & EAST_WALL) != EAST_WALL) && (c < (cols - 1)) && (dist[r][c + 1] == NO_ROUTE))
+        {
+            dist[r][c + 1] = dist[r][c] + 1;
+            queue[tail++] = r * SIZE + c + 1;
+        }
+        if (((maze[r][c] & SOUTH_WALL) != SOUTH_WALL) && (r != 0) && (dist[r - 1][c] == NO_ROUTE))
+        {
+            dist[r - 1][c] = dist[r][c] + 1;
+            queue[tail++] = (r - 1) * SIZE + c;
+        }
+        if (((maze[r][c] & WEST_WALL) != WEST_WALL) && (c != 0) && (dist[r][c - 1] == NO_ROUTE))
+        {
+            dist[r][c - 1] = dist[r][c] + 1;
+            queue[tail++] = r * SIZE + c - 1;
+        }
+    }
+}
+
+// Running the mouse exploration until it gets to destination or runs out of budget
+// Returns why the exploration stopped, the number of moves and the cells found on the way (0 if destination is not reached)
+unsigned int Explore_To_Destination(unsigned int maze[SIZE][SIZE], const struct Explore_Budget *p_budget, unsigned int *p_moves, unsigned int *p_cells)
+{
+    unsigned int mouse_maze[SIZE][SIZE], discovered_cells[SIZE][SIZE];
+    unsigned int r, c, end_reason = END_NONE;
+    struct Mouse_Settings mouse;
+    struct Budget_Tracker tracker;
+
+    Mouse_Setup(&mouse);
+    Mouse_Maze_Setup(mouse_maze);
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            discovered_cells[r][c] = 0;
+    discovered_cells[0][0] = 1;
+    Budget_Setup(&tracker);
+
+    while (!mouse.destination_found && (end_reason == END_NONE))
+    {
+        r = mouse.pos_y;
+        c = mouse.pos_x;
+        Budget_Decision_Start(p_budget, &tracker);
+        Mouse_Exploring(maze, mouse_maze, &mouse, discovered_cells);
+        Budget_Decision_Stop(p_budget, &tracker);
+        Walls_Check(maze, &mouse, mouse_maze);
+        end_reason = Budget_Check(p_budget, &tracker, (mouse.pos_y != r) || (mouse.pos_x != c));
+    }
+
+    if (mouse.destination_found)
+        end_reason = END_COMPLETE;
+    *p_moves = (end_reason == END_COMPLETE) ? tracker.moves : 0;
+    *p_cells = (end_reason == END_COMPLETE) ? mouse.cells_found : 0;
+    return end_reason;
+}
+
+void Maze_Features(const struct Maze_Route *p_route, const struct Explore_Budget *p_budget, struct Maze_Stats *p_stats)
+{
+    unsigned int maze[SIZE][SIZE], dist[SIZE][SIZE];
+    unsigned int r, c, openings, edges = 0, choices = 0, passages = 0;
+    unsigned int components = 0, queue[SIZE * SIZE], seen[SIZE][SIZE], head, tail;
+
+    Generate_Maze(maze);
+    Generate_Route(maze, p_route);
+
+    Maze_Distances(maze, p_route->rows, p_route->cols, dist);
+    p_stats->shortest_path = dist[0][0];
+
+    p_stats->dead_ends = 0;
+    p_stats->junctions = 0;
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+        {
+            openings = Cell_Openings(maze, p_route->rows, p_route->cols, r, c);
+            edges += openings;
+            seen[r][c] = 0;
+
+            if ((openings == 1) && ((r != 0) || (c != 0))) // The first cell always has one way out
+                p_stats->dead_ends++;
+            else if (openings > 1)
+            {
+                choices += openings - 1;
+                passages++;
+                if (openings > 2)
+                    p_stats->junctions++;
+            }
+        }
+    edges /= 2; // Each passage is counted from both sides
+
+    p_stats->branching = passages ? (choices * 100) / passages : 0;
+
+    // Separate parts of the maze - Flood Fill from every cell not reached yet
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+            if (!seen[r][c])
+            {
+                components++;
+                seen[r][c] = 1;
+                head = tail = 0;
+                queue[tail++] = r * SIZE + c;
+                while (head != tail)
+                {
+                    unsigned int cell_r = queue[head] / SIZE, cell_c = queue[head] % SIZE;
+                    head++;
+
+                    if (((maze[cell_r][cell_c] & NORTH_WALL) != NORTH_WALL) && (cell_r < (p_route->rows - 1)) && !seen[cell_r + 1][cell_c])
+                    {
+                        seen[cell_r + 1][cell_c] = 1;
+                        queue[tail++] = (cell_r + 1) * SIZE + cell_c;
+                    }
+                    if (((maze[cell_r][cell_c] & EAST_WALL) != EAST_WALL) && (cell_c < (p_route->cols - 1)) && !seen[cell_r][cell_c + 1])
+                    {
+                        seen[cell_r][cell_c + 1] = 1;
+                        queue[tail++] = cell_r * SIZE + cell_c + 1;
+                    }
+                    if (((maze[cell_r][cell_c] & SOUTH_WALL) != SOUTH_WALL) && (cell_r != 0) && !seen[cell_r - 1][cell_c])
+                    {
+                        seen[cell_r - 1][cell_c] = 1;
+                        queue[tail++] = (cell_r - 1) * SIZE + cell_c;
+                    }
+                    if (((maze[cell_r][cell_c] & WEST_WALL) != WEST_WALL) && (cell_c != 0) && !seen[cell_r][cell_c - 1])
+                    {
+                        seen[cell_r][cell_c - 1] = 1;
+                        queue[tail++] = cell_r * SIZE + cell_c - 1;
+                    }
+                }
+            }
+
+    // Independent loops of the maze (circuit rank)
+    p_stats->loops = edges + components - (p_route->rows * p_route->cols);
+
+    p_stats->end_reason = Explore_To_Destination(maze, p_budget, &p_stats->explore_moves, &p_stats->explore_cells);
+}
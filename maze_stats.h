@@ -0,0 +1,49 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#ifndef MAZE_STATS_H
+#define MAZE_STATS_H
+
+#include "micromouse.h"
+
+#define MAX_EXPLORE_MOVES 1000 // Default move budget - the mouse is considered lost after it
+
+struct Maze_Stats
+{
+    unsigned int shortest_path;             // Moves from the first cell to destination - NO_ROUTE if unreachable
+    unsigned int loops, dead_ends, junctions;
+    unsigned int branching;                 // Average extra choices per cell that is not a dead end (x100)
+    unsigned int explore_moves, explore_cells; // Mouse exploration until destination - 0 if never reached
+    unsigned int end_reason;                   // Why the exploration stopped (END_COMPLETE = destination reached)
+};
+
+unsigned int Cell_Openings(unsigned int maze[SIZE][SIZE], unsigned int rows, unsigned int cols, unsigned int r, unsigned int c);
+void Maze_Distances(unsigned int maze[SIZE][SIZE], unsigned int rows, unsigned int cols, unsigned int dist[SIZE][SIZE]);
+unsigned int Explore_To_Destination(unsigned int maze[SIZE][SIZE], const struct Explore_Budget *p_budget, unsigned int *p_moves, unsigned int *p_cells);
+void Maze_Features(const struct Maze_Route *p_route, const struct Explore_Budget *p_budget, struct Maze_Stats *p_stats);
+
+#endif
@@ -0,0 +1,1052 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "micromouse.h"
+
+// Generating a maze to simulate an environement
+void Generate_Maze(unsigned int maze[SIZE][SIZE])
+{
+    unsigned int r, c;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+        {
+            maze[r][c] = 15;
+        }
+}
+
+// Generating the right route to get to destination
+void Generate_Route(unsigned int maze[SIZE][SIZE], const struct Maze_Route *p_route)
+{
+    unsigned int r, c, route;
+
+    for (r = 0; r < p_route->rows; r++)
+        for (c = 0; c < p_route->cols; c++)
+        {
+            route = p_route->cells[(p_route->rows - 1) - r][c]; // Routes are written from the top row
+
+            // Outside walls are never removed
+            if (((route & NORTH_WALL) == NORTH_WALL) && (r < (p_route->rows - 1)))
+            {
+                // Removing North wall from current cell
+                if ((maze[r][c] & NORTH_WALL) == NORTH_WALL)
+                    maze[r][c] ^= NORTH_WALL;
+                // Removing South wall from next cell
+                if ((maze[r + 1][c] & SOUTH_WALL) == SOUTH_WALL)
+                    maze[r + 1][c] ^= SOUTH_WALL;
+            }
+            if (((route & EAST_WALL) == EAST_WALL) && (c < (p_route->cols - 1)))
+            {
+                // Removing East wall from current cell
+                if ((maze[r][c] & EAST_WALL) == EAST_WALL)
+                    maze[r][c] ^= EAST_WALL;
+                // Removing West wall from next cell
+                if ((maze[r][c + 1] & WEST_WALL) == WEST_WALL)
+                    maze[r][c + 1] ^= WEST_WALL;
+            }
+            if (((route & SOUTH_WALL) == SOUTH_WALL) && (r != 0))
+            {
+                // Removing South wall from current cell
+                if ((maze[r][c] & SOUTH_WALL) == SOUTH_WALL)
+                    maze[r][c] ^= SOUTH_WALL;
+                // Removing North wall from previous cell
+                if ((maze[r - 1][c] & NORTH_WALL) == NORTH_WALL)
+                    maze[r - 1][c] ^= NORTH_WALL;
+            }
+            if (((route & WEST_WALL) == WEST_WALL) && (c != 0))
+            {
+                if ((maze[r][c] & WEST_WALL) == WEST_WALL)
+                    maze[r][c] ^= WEST_WALL;
+
+                if ((maze[r][c - 1] & EAST_WALL) == EAST_WALL)
+                    maze[r][c - 1] ^= EAST_WALL;
+            }
+        }
+}
+
+// Show the "values" of the walls
+void Print_Maze(unsigned int maze[SIZE][SIZE], const struct Maze_Route *p_route)
+{
+    unsigned int r, c;
+
+    printf("--- Generated Maze ----\n");
+    for (r = p_route->rows; r > 0; r--)
+    {
+        for (c = 0; c < p_route->cols; c++)
+        {
+            printf("%d\t", maze[r - 1][c]);
+        }
+        printf("\n");
+    }
+    printf("\n\n");
+}
+
+void Print_Mouse_Maze(unsigned int mouse_maze[SIZE][SIZE])
+{
+    int r, c, cell_value;
+
+    printf("--- Maze Known by the Mouse ---\n");
+    for (r = (SIZE - 1); r > -1; r--)
+    {
+        for (c = 0; c < SIZE; c++)
+        {
+            cell_value = mouse_maze[r][c];
+
+            // we want to see just the walls
+            // OR if the cell is OUT OF BOUNDS
+            if ((cell_value & CELL_OUT) == CELL_OUT)
+                cell_value = CELL_OUT;
+            else
+            {
+                if ((cell_value & DEST_CELL) == DEST_CELL)
+                    cell_value ^= DEST_CELL;
+                if ((cell_value & CELL_VISITED) == CELL_VISITED)
+                    cell_value ^= CELL_VISITED;
+                if ((cell_value & CELL_USED) == CELL_USED)
+                    cell_value ^= CELL_USED;
+            }
+
+            printf("%d\t", cell_value);
+        }
+        printf("\n");
+    }
+    printf("\n\n");
+
+    printf("--- Final Route to Destination ---\n");
+    for (r = (SIZE - 1); r > -1; r--)
+    {
+        for (c = 0; c < SIZE; c++)
+        {
+            if ((mouse_maze[r][c] & CELL_USED) == CELL_USED)
+                printf("1");
+            else
+                printf("0");
+            printf("\t");
+        }
+        printf("\n");
+    }
+}
+
+void Mouse_Setup(struct Mouse_Settings *p_mouse)
+{
+    unsigned int r, c;
+
+    // Mouse Starting position
+    p_mouse->pos_x = 0;
+    p_mouse->pos_y = 0;
+
+    // Possible directions referred to walls
+    p_mouse->dirs[0] = NORTH_WALL;
+    p_mouse->dirs[1] = EAST_WALL;
+    p_mouse->dirs[2] = SOUTH_WALL;
+    p_mouse->dirs[3] = WEST_WALL;
+    // Poiting Upwards/North
+    p_mouse->m_dir = NORTH;
+
+    // Nothing is known
+    p_mouse->sides_found = 0;
+    p_mouse->dest_cells_found = 0;
+    p_mouse->destination_found = 0;
+    p_mouse->cells_found = 1; // Mouse knows the first cell
+
+    // Clearing -> Cells previously visited
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            p_mouse->prev_cells[r][c] = 0;
+
+    p_mouse->prev_cell = 1; // This will represent the first of the last 8 visited cells
+    p_mouse->prev_cell_x = 99;
+    p_mouse->prev_cell_y = 99;
+    p_mouse->prev_cells[0][0] = p_mouse->prev_cell; // Starting position
+}
+
+void Mouse_Maze_Setup(unsigned int mouse_maze[SIZE][SIZE])
+{
+    unsigned int r, c;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+        {
+            mouse_maze[r][c] = 0;
+            if (r == 0)
+                mouse_maze[r][c] |= SOUTH_WALL;
+            else if (r == (SIZE - 1))
+                mouse_maze[r][c] |= NORTH_WALL;
+            if (c == 0)
+                mouse_maze[r][c] |= WEST_WALL;
+            else if (c == (SIZE - 1))
+                mouse_maze[r][c] |= EAST_WALL;
+        }
+
+    // Setting first cell of the maze (3 mandatory walls)
+    mouse_maze[0][0] |= EAST_WALL;
+    mouse_maze[0][0] |= CELL_VISITED;
+    mouse_maze[0][1] |= WEST_WALL; // Caused by the setup of the first cell
+
+    // Setting Main destination cell
+    mouse_maze[3][3] |= DEST_CELL;
+}
+
+void Mouse_Exploring(unsigned int maze[SIZE][SIZE], unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse, unsigned int discovered_cells[SIZE][SIZE])
+{
+    unsigned int chosen_dir = 99, temp_prev_cell, stop = 1;
+    int turn_check;
+
+    unsigned int i, r, c, temp_dir, prev_cell_check = 99;
+
+    unsigned int poss_dirs[4];
+    for (i = 0; i < 4; i++) // Setting array
+        poss_dirs[i] = 99;
+
+    temp_dir = p_mouse->m_dir;
+    // Find all of the cells - Flood Fill
+    if (p_mouse->cells_found != TOT_CELLS)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & p_mouse->dirs[temp_dir]) != p_mouse->dirs[temp_dir]) // checking for a wall
+            {
+                // Checking if North is Out of Bound
+                if ((temp_dir == NORTH) && ((mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] & CELL_OUT) != CELL_OUT))
+                {
+                    // Checking if next cell has been visited
+                    if (
+                        ((mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] & CELL_VISITED) != CELL_VISITED) ||
+                        // Get out of the Destination Loop
+                        ((p_mouse->dest_cells_found == TOT_DEST_CELLS) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & DEST_CELL) == DEST_CELL) && ((mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] & DEST_CELL) != DEST_CELL)))
+                    {
+                        chosen_dir = temp_dir;
+                        stop = 0;
+                        break;
+                    }
+                    else
+                    {
+                        poss_dirs[i] = NORTH;                                            // possible route
+                        if (p_mouse->prev_cells[p_mouse->pos_y + 1][p_mouse->pos_x] > 0) // checking if north cell is the previous cell
+                            prev_cell_check = NORTH;
+                    }
+                }
+
+                // Checking if East is Out of Bound
+                else if ((temp_dir == EAST) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] & CELL_OUT) != CELL_OUT))
+                {
+                    if (
+                        ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] & CELL_VISITED) != CELL_VISITED) ||
+                        // Get out of the Destination Loop
+                        ((p_mouse->dest_cells_found == TOT_DEST_CELLS) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & DEST_CELL) == DEST_CELL) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] & DEST_CELL) != DEST_CELL)))
+                    {
+                        chosen_dir = temp_dir;
+                        stop = 0;
+                        break;
+                    }
+                    else
+                    {
+                        poss_dirs[i] = EAST;                                             // possible route
+                        if (p_mouse->prev_cells[p_mouse->pos_y][p_mouse->pos_x + 1] > 0) // checking if east cell is the previous cell
+                            prev_cell_check = EAST;
+                    }
+                }
+
+                // Checking if South is Out of Bound
+                else if ((temp_dir == SOUTH) && ((mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] & CELL_OUT) != CELL_OUT))
+                {
+                    if (
+                        ((mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] & CELL_VISITED) != CELL_VISITED) ||
+                        // Get out of the Destination Loop
+                        ((p_mouse->dest_cells_found == TOT_DEST_CELLS) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & DEST_CELL) == DEST_CELL) && ((mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] & DEST_CELL) != DEST_CELL)))
+                    {
+                        chosen_dir = temp_dir;
+                        stop = 0;
+                        break;
+                    }
+                    else
+                    {
+                        poss_dirs[i] = SOUTH;                                            // possible route
+                        if (p_mouse->prev_cells[p_mouse->pos_y - 1][p_mouse->pos_x] > 0) // checking if south cell is the previous cell
+                            prev_cell_check = SOUTH;
+                    }
+                }
+
+                // Checking if West is Out of Bound
+                else if ((temp_dir == WEST) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] & CELL_OUT) != CELL_OUT))
+                {
+                    if (
+                        ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] & CELL_VISITED) != CELL_VISITED) ||
+                        // Get out of the Destination Loop
+                        ((p_mouse->dest_cells_found == TOT_DEST_CELLS) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & DEST_CELL) == DEST_CELL) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] & DEST_CELL) != DEST_CELL)))
+                    {
+                        chosen_dir = temp_dir;
+                        stop = 0;
+                        break;
+                    }
+                    else
+                    {
+                        poss_dirs[i] = WEST;                                             // possible route
+                        if (p_mouse->prev_cells[p_mouse->pos_y][p_mouse->pos_x - 1] > 0) // checking if west cell is the previous cell
+                            prev_cell_check = WEST;
+                    }
+                }
+            }
+
+            // Check next way to the right (clockwise)
+            temp_dir += 1;
+            if (temp_dir > WEST)
+                temp_dir = NORTH;
+        }
+
+        // If all cells around have already been visited give a priority
+        // Priorities - NOT previous cell, Out of the loop if all dest cells have been found, clockwise choice
+        if (stop == 1)
+            for (i = 0; i < 4; i++)
+                if (poss_dirs[i] != 99)
+                {
+                    chosen_dir = poss_dirs[i];
+                    stop = 0;
+                    if (chosen_dir != prev_cell_check)
+                    {
+                        break; // prev cell secondary option
+                    }
+                }
+
+        // Only visited cells around - the priorities above can keep going round the same cells, heading to the
+        // closest cell not visited yet instead
+        if ((stop == 1) || ((mouse_maze[p_mouse->pos_y + (chosen_dir == NORTH) - (chosen_dir == SOUTH)][p_mouse->pos_x + (chosen_dir == EAST) - (chosen_dir == WEST)] & CELL_VISITED) == CELL_VISITED))
+        {
+            temp_dir = Plan_Frontier(mouse_maze, p_mouse->pos_y, p_mouse->pos_x);
+            if (temp_dir != 99)
+            {
+                chosen_dir = temp_dir;
+                stop = 0;
+            }
+        }
+    }
+
+    // If all cells have been found, move back to first cell
+    // Follow the lowest number of the discovered cells order
+    else if (discovered_cells[p_mouse->pos_y][p_mouse->pos_x] != 1) // Don't move if inside first cell
+    {
+        temp_dir = discovered_cells[p_mouse->pos_y][p_mouse->pos_x];
+
+        // North checking
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & NORTH_WALL) != NORTH_WALL) // Wall check
+            if (discovered_cells[p_mouse->pos_y + 1][p_mouse->pos_x] < temp_dir)
+            {
+                temp_dir = discovered_cells[p_mouse->pos_y + 1][p_mouse->pos_x];
+                chosen_dir = NORTH; // Lower number check
+            }
+
+        // East checking
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & EAST_WALL) != EAST_WALL) // Wall check
+            if (discovered_cells[p_mouse->pos_y][p_mouse->pos_x + 1] < temp_dir)
+            {
+                temp_dir = discovered_cells[p_mouse->pos_y][p_mouse->pos_x + 1];
+                chosen_dir = EAST; // Lower number check
+            }
+
+        // South checking
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & SOUTH_WALL) != SOUTH_WALL) // Wall check
+            if (discovered_cells[p_mouse->pos_y - 1][p_mouse->pos_x] < temp_dir)
+            {
+                temp_dir = discovered_cells[p_mouse->pos_y - 1][p_mouse->pos_x];
+                chosen_dir = SOUTH; // Lower number check
+            }
+
+        // West checking
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & WEST_WALL) != WEST_WALL) // Wall check
+            if (discovered_cells[p_mouse->pos_y][p_mouse->pos_x - 1] < temp_dir)
+            {
+                temp_dir = discovered_cells[p_mouse->pos_y][p_mouse->pos_x - 1];
+                chosen_dir = WEST; // Lower number check
+            }
+        // printf("\n\ntemp_dir = %d\n\n", temp_dir);
+        if (chosen_dir != 99) // Don't move if no lower number has been found
+            stop = 0;
+    }
+
+    if (stop == 0) // move if allowed
+    {
+        //---Turn Right/Left---
+        // Negative = left; Positive = Right; Zero = No turning
+        turn_check = chosen_dir - p_mouse->m_dir;
+        if ((turn_check == 3) || (turn_check == -3))
+            turn_check /= -3;
+
+        // Simulation purposes - Directly set Mouse Direction
+        p_mouse->m_dir = chosen_dir;
+
+        // Storing current cell as previous cell before movement
+        p_mouse->prev_cell_x = p_mouse->pos_x;
+        p_mouse->prev_cell_y = p_mouse->pos_y;
+
+        // Forward Movement
+        if (p_mouse->m_dir == NORTH)
+            p_mouse->pos_y += 1;
+        else if (p_mouse->m_dir == EAST)
+            p_mouse->pos_x += 1;
+        else if (p_mouse->m_dir == SOUTH)
+            p_mouse->pos_y -= 1;
+        else if (p_mouse->m_dir == WEST)
+            p_mouse->pos_x -= 1;
+
+        //--- Checking if the mouse went back to previously visited cells ---
+        // Current cell is not part of the last # of visited cells
+        if (p_mouse->prev_cells[p_mouse->pos_y][p_mouse->pos_x] == 0)
+        {
+            if (p_mouse->prev_cell != LAST_VIS_CELLS)
+                p_mouse->prev_cell += 1;
+            else
+                for (r = 0; r < SIZE; r++)
+                    for (c = 0; c < SIZE; c++)
+                        if (p_mouse->prev_cells[r][c] > 0)
+                            p_mouse->prev_cells[r][c] -= 1;
+
+            p_mouse->prev_cells[p_mouse->pos_y][p_mouse->pos_x] = p_mouse->prev_cell;
+        }
+
+        // Mouse came bake to one of the # previously visited cells
+        else if ((mouse_maze[p_mouse->prev_cell_y][p_mouse->prev_cell_x] & CELL_OUT) != CELL_OUT) // Checking if the mouse's last cell was an a CELL OUT
+        {
+            temp_prev_cell = p_mouse->prev_cell;
+            while (temp_prev_cell > p_mouse->prev_cells[p_mouse->pos_y][p_mouse->pos_x])
+            {
+                for (r = 0; r < SIZE; r++)
+                    for (c = 0; c < SIZE; c++)
+                    {
+                        if ((r == 0) && (c == 0))
+                            continue;
+                        else if (p_mouse->prev_cells[r][c] == temp_prev_cell)
+                        {
+                            if (
+                                // North
+                                (
+                                    ((mouse_maze[r][c] & NORTH_WALL) != NORTH_WALL) &&
+                                    ((mouse_maze[r + 1][c] & CELL_OUT) != CELL_OUT) &&
+                                    ((mouse_maze[r + 1][c] & CELL_VISITED) != CELL_VISITED))
+
+                                ||
+
+                                // East
+                                (
+                                    ((mouse_maze[r][c] & EAST_WALL) != EAST_WALL) &&
+                                    ((mouse_maze[r][c + 1] & CELL_OUT) != CELL_OUT) &&
+                                    ((mouse_maze[r][c + 1] & CELL_VISITED) != CELL_VISITED))
+
+                                ||
+
+                                // South
+                                (
+                                    ((mouse_maze[r][c] & SOUTH_WALL) != SOUTH_WALL) &&
+                                    ((mouse_maze[r - 1][c] & CELL_OUT) != CELL_OUT) &&
+                                    ((mouse_maze[r - 1][c] & CELL_VISITED) != CELL_VISITED))
+
+                                ||
+
+                                // West
+                                (
+                                    ((mouse_maze[r][c] & WEST_WALL) != WEST_WALL) &&
+                                    ((mouse_maze[r][c - 1] & CELL_OUT) != CELL_OUT) &&
+                                    ((mouse_maze[r][c - 1] & CELL_VISITED) != CELL_VISITED)))
+                                break;
+                            else if ((mouse_maze[r][c] & DEST_CELL) != DEST_CELL)
+                            {
+                                mouse_maze[r][c] |= CELL_OUT;
+                            }
+                        }
+                    }
+                temp_prev_cell -= 1;
+            }
+
+            // Resetting the last # visited cells memory
+            for (r = 0; r < SIZE; r++)
+                for (c = 0; c < SIZE; c++)
+                    p_mouse->prev_cells[r][c] = 0;
+            p_mouse->prev_cell = 1;
+            p_mouse->prev_cells[p_mouse->pos_y][p_mouse->pos_x] = p_mouse->prev_cell;
+        }
+    }
+}
+
+void Walls_Check(unsigned int maze[SIZE][SIZE], struct Mouse_Settings *p_mouse, unsigned int mouse_maze[SIZE][SIZE])
+{
+    unsigned int i, walls_no = 0;
+
+    // Adding walls in the unvisited cells
+    if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & CELL_VISITED) != CELL_VISITED) // Check if mouse has already been in current cell
+    {
+        //--- ADDING WALLS ---
+        // North
+        if ((maze[p_mouse->pos_y][p_mouse->pos_x] & NORTH_WALL) == NORTH_WALL) // Checking if there is a wall in front
+        {
+            mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= NORTH_WALL; // Add top wall
+            if (p_mouse->pos_y != (SIZE - 1))
+                mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] |= SOUTH_WALL; // Add back wall to the following row
+        }
+        // East
+        if ((maze[p_mouse->pos_y][p_mouse->pos_x] & EAST_WALL) == EAST_WALL) // Checking if there is a wall on the right
+        {
+            mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= EAST_WALL; // Add right wall
+            if (p_mouse->pos_x != (SIZE - 1))
+                mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] |= WEST_WALL; // Add left wall to the following column
+        }
+        // South
+        if ((maze[p_mouse->pos_y][p_mouse->pos_x] & SOUTH_WALL) == SOUTH_WALL) // Checking if there is a wall below
+        {
+            mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= SOUTH_WALL; // Add bottom wall
+            if (p_mouse->pos_y != 0)
+                mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] |= NORTH_WALL; // Add top wall to the previous row
+        }
+        // West
+        if ((maze[p_mouse->pos_y][p_mouse->pos_x] & WEST_WALL) == WEST_WALL) // Checking if there is a wall on the left
+        {
+            mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= WEST_WALL; // Add left wall
+            if (p_mouse->pos_x != 0)
+                mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] |= EAST_WALL; // Add right wall to the previous column
+        }
+
+        //--- Destination Cells --- (setting cells beside the registered dest cell)
+        if (p_mouse->dest_cells_found != TOT_DEST_CELLS)
+            if (
+                // Checking if a destination cell is on North
+                ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & NORTH_WALL) != NORTH_WALL) && ((mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] & DEST_CELL) == DEST_CELL) ||
+                // Checking if a destination cell is on East
+                ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & EAST_WALL) != EAST_WALL) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] & DEST_CELL) == DEST_CELL) ||
+                // Checking if a destination cell is on South
+                ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & SOUTH_WALL) != SOUTH_WALL) && ((mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] & DEST_CELL) == DEST_CELL) ||
+                // Checking if a destination cell is on West
+                ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & WEST_WALL) != WEST_WALL) && ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] & DEST_CELL) == DEST_CELL))
+                // If a destination cell is found on either side of the current cell - check the walls arrangement
+                if (
+                    ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & VERT_WALLS) != VERT_WALLS) &&
+                    ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & HORIZ_WALLS) != HORIZ_WALLS))
+                {
+                    // If the walls arrangement does not match the destination entrance one then set the current cell as dest cell
+                    mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= DEST_CELL;
+                    p_mouse->dest_cells_found += 1;
+                }
+
+        mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= CELL_VISITED;
+        p_mouse->cells_found += 1;
+    }
+
+    // Checking which one is the 6/8 cells side
+    if (p_mouse->sides_found == 0)
+    {
+        unsigned int r, c;
+
+        // The mouse knows when it ARRIVES in the cell
+        if (p_mouse->pos_y >= (SIZE - 2))
+        {
+            // Shifting maze to the left (adding RIGHT walls)
+            for (r = 0; r < SIZE; r++)
+            {
+                mouse_maze[r][SIZE - 3] |= EAST_WALL;
+                mouse_maze[r][SIZE - 2] |= CELL_OUT;
+                mouse_maze[r][SIZE - 1] |= CELL_OUT;
+            }
+
+            p_mouse->sides_found = 1;
+        }
+
+        else if (p_mouse->pos_x >= (SIZE - 2))
+        {
+            // Shifting top rows (adding TOP walls)
+            for (c = 0; c < SIZE; c++)
+            {
+                mouse_maze[SIZE - 3][c] |= NORTH_WALL;
+                mouse_maze[SIZE - 2][c] |= CELL_OUT;
+                mouse_maze[SIZE - 1][c] |= CELL_OUT;
+            }
+
+            p_mouse->sides_found = 1;
+        }
+    }
+
+    // Checking if Destination has been found
+    if (p_mouse->destination_found == 0)
+        if ((p_mouse->pos_y == 3) && (p_mouse->pos_x == 3))
+            p_mouse->destination_found = 1;
+
+    // Setting Out of Bound Cell
+    if (((p_mouse->pos_y == 0) & (p_mouse->pos_x != 0)) || ((p_mouse->pos_y != 0) & (p_mouse->pos_x == 0)) || ((p_mouse->pos_y != 0) & (p_mouse->pos_x != 0))) // Excluding the first cell
+    {
+        for (i = 0; i < 4; i++)
+            if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & p_mouse->dirs[i]) == p_mouse->dirs[i]) // Checking how many walls are in the current cell
+                walls_no += 1;
+
+        //---Out cells count as walls---
+
+        // North cell
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & NORTH_WALL) != NORTH_WALL)
+            if ((mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] & CELL_OUT) == CELL_OUT)
+                walls_no += 1;
+
+        // East cell
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & EAST_WALL) != EAST_WALL)
+            if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] & CELL_OUT) == CELL_OUT)
+                walls_no += 1;
+
+        // South cell
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & SOUTH_WALL) != SOUTH_WALL)
+            if ((mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] & CELL_OUT) == CELL_OUT)
+                walls_no += 1;
+
+        // West cell
+        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & WEST_WALL) != WEST_WALL)
+            if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] & CELL_OUT) == CELL_OUT)
+                walls_no += 1;
+
+        if (walls_no == 3)
+            mouse_maze[p_mouse->pos_y][p_mouse->pos_x] |= CELL_OUT; // This cell brings nowhere
+    }
+}
+
+void Solving(unsigned int mouse_maze[SIZE][SIZE], unsigned int discovered_cells[SIZE][SIZE])
+{
+    unsigned int r, c, r_check, c_check, cell_check;
+
+    mouse_maze[0][0] |= CELL_USED; // First cell will always be used
+
+    // Store order number of the cell destination
+    cell_check = discovered_cells[Y_DEST][X_DEST];
+    if (cell_check == 0) // Destination has not been found
+        return;
+
+    // Following discovered cells order
+    while (cell_check != 1)
+    {
+        for (r = 0; r < SIZE; r++)
+            for (c = 0; c < SIZE; c++)
+                if (discovered_cells[r][c] == cell_check)
+                {
+                    mouse_maze[r][c] |= CELL_USED;
+                    r_check = r;
+                    c_check = c; // storing found position
+                }
+
+        // Checking around current "cell_check" which cell has the next LOWEST order value
+
+        // NORTH value check
+        if ((mouse_maze[r_check][c_check] & NORTH_WALL) != NORTH_WALL)
+            if ((discovered_cells[r_check + 1][c_check] < cell_check) && (discovered_cells[r_check + 1][c_check] > 0))
+                cell_check = discovered_cells[r_check + 1][c_check];
+
+        // EAST value check
+        if ((mouse_maze[r_check][c_check] & EAST_WALL) != EAST_WALL)
+            if ((discovered_cells[r_check][c_check + 1] < cell_check) && (discovered_cells[r_check][c_check + 1] > 0))
+                cell_check = discovered_cells[r_check][c_check + 1];
+
+        // SOUTH value check
+        if ((mouse_maze[r_check][c_check] & SOUTH_WALL) != SOUTH_WALL)
+            if ((discovered_cells[r_check - 1][c_check] < cell_check) && (discovered_cells[r_check - 1][c_check] > 0))
+                cell_check = discovered_cells[r_check - 1][c_check];
+
+        // WEST value check
+        if ((mouse_maze[r_check][c_check] & WEST_WALL) != WEST_WALL)
+            if ((discovered_cells[r_check][c_check - 1] < cell_check) && (discovered_cells[r_check][c_check - 1] > 0))
+                cell_check = discovered_cells[r_check][c_check - 1];
+    }
+}
+
+void ToDest(unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse)
+{
+    // Storing current cell mapping
+    p_mouse->prev_cell_x = p_mouse->pos_x;
+    p_mouse->prev_cell_y = p_mouse->pos_y;
+
+    while ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & DEST_CELL) != DEST_CELL)
+    {
+        // Moving towards the direction of the next cell SET AS USED
+        // Also, making sure it does not go to previous cell
+
+        // NORTH
+        if (((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & NORTH_WALL) != NORTH_WALL) && ((p_mouse->pos_y + 1) != p_mouse->prev_cell_y))
+            if ((mouse_maze[p_mouse->pos_y + 1][p_mouse->pos_x] & CELL_USED) == CELL_USED)
+            {
+                p_mouse->prev_cell_y = p_mouse->pos_y;
+                p_mouse->pos_y += 1;
+            }
+
+            // EAST
+            else if (((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & EAST_WALL) != EAST_WALL) && ((p_mouse->pos_x + 1) != p_mouse->prev_cell_x))
+                if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x + 1] & CELL_USED) == CELL_USED)
+                {
+                    p_mouse->prev_cell_x = p_mouse->pos_x;
+                    p_mouse->pos_x += 1;
+                }
+
+                // SOUTH
+                else if (((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & SOUTH_WALL) != SOUTH_WALL) && ((p_mouse->pos_y - 1) != p_mouse->prev_cell_y))
+                    if ((mouse_maze[p_mouse->pos_y - 1][p_mouse->pos_x] & CELL_USED) == CELL_USED)
+                    {
+                        p_mouse->prev_cell_y = p_mouse->pos_y;
+                        p_mouse->pos_y -= 1;
+                    }
+
+                    // WEST
+                    else if (((mouse_maze[p_mouse->pos_y][p_mouse->pos_x] & WEST_WALL) != WEST_WALL) && ((p_mouse->pos_x - 1) != p_mouse->prev_cell_x))
+                        if ((mouse_maze[p_mouse->pos_y][p_mouse->pos_x - 1] & CELL_USED) == CELL_USED)
+                        {
+                            p_mouse->prev_cell_x = p_mouse->pos_x;
+                            p_mouse->pos_x -= 1;
+                        }
+    }
+}
+
+void Plan_Cache_Setup(struct Plan_Cache *p_cache)
+{
+    p_cache->valid = 0;
+    p_cache->queries = 0;
+    p_cache->hits = 0;
+}
+
+// Checking if the mouse can move from a cell towards a direction
+// Unknown walls are assumed open unless only known passages are allowed
+unsigned int Plan_Passage(unsigned int mouse_maze[SIZE][SIZE], unsigned int r, unsigned int c, unsigned int dir, unsigned int known_only)
+{
+    unsigned int next_r = r, next_c = c, back_wall;
+
+    if (dir == NORTH)
+    {
+        if (r == (SIZE - 1))
+            return 0;
+        next_r = r + 1;
+        back_wall = SOUTH_WALL;
+    }
+    else if (dir == EAST)
+    {
+        if (c == (SIZE - 1))
+            return 0;
+        next_c = c + 1;
+        back_wall = WEST_WALL;
+    }
+    else if (dir == SOUTH)
+    {
+        if (r == 0)
+            return 0;
+        next_r = r - 1;
+        back_wall = NORTH_WALL;
+    }
+    else
+    {
+        if (c == 0)
+            return 0;
+        next_c = c - 1;
+        back_wall = EAST_WALL;
+    }
+
+    // A wall is only ever stored once it has been seen
+    if (((mouse_maze[r][c] & (NORTH_WALL >> dir)) != 0) || ((mouse_maze[next_r][next_c] & back_wall) != 0))
+        return 0;
+
+    // Walls of a visited cell have all been read - the passage is certain
+    if (known_only)
+        return ((mouse_maze[r][c] & CELL_VISITED) == CELL_VISITED) || ((mouse_maze[next_r][next_c] & CELL_VISITED) == CELL_VISITED);
+
+    return 1;
+}
+
+// Checking if a whole row/column has been set Out of Bound by the 6/8 side check
+unsigned int Plan_Side_Out(unsigned int mouse_maze[SIZE][SIZE], unsigned int top)
+{
+    unsigned int i;
+
+    for (i = 0; i < SIZE; i++)
+        if ((top && ((mouse_maze[SIZE - 1][i] & CELL_OUT) != CELL_OUT)) || (!top && ((mouse_maze[i][SIZE - 1] & CELL_OUT) != CELL_OUT)))
+            return 0;
+    return 1;
+}
+
+// Checking if a cell is (or could still be) a destination cell
+unsigned int Plan_Goal(unsigned int mouse_maze[SIZE][SIZE], unsigned int r, unsigned int c, unsigned int known_only)
+{
+    if ((mouse_maze[r][c] & DEST_CELL) == DEST_CELL)
+        return 1;
+    // Visited cells have already been checked for being destination cells
+    if (known_only || ((mouse_maze[r][c] & CELL_VISITED) == CELL_VISITED))
+        return 0;
+
+    // Destination square of a 6x8 maze (unless the top rows are Out of Bound)
+    if (((c == X_DEST - 1) || (c == X_DEST)) && ((r == Y_DEST) || (r == Y_DEST + 1)) && !Plan_Side_Out(mouse_maze, 1))
+        return 1;
+    // Destination square of a 8x6 maze (unless the right columns are Out of Bound)
+    if (((c == X_DEST) || (c == X_DEST + 1)) && ((r == Y_DEST - 1) || (r == Y_DEST)) && !Plan_Side_Out(mouse_maze, 0))
+        return 1;
+
+    return 0;
+}
+
+// Number of moves from every cell to the cells at distance 0 - Flood Fill
+void Plan_Flood(unsigned int mouse_maze[SIZE][SIZE], unsigned int dist[SIZE][SIZE], unsigned int known_only)
+{
+    unsigned int queue[SIZE * SIZE], head = 0, tail = 0;
+    unsigned int r, c, dir, next_r, next_c;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            if (dist[r][c] == 0)
+                queue[tail++] = r * SIZE + c;
+
+    while (head != tail)
+    {
+        r = queue[head] / SIZE;
+        c = queue[head] % SIZE;
+        head++;
+
+        for (dir = NORTH; dir <= WEST; dir++)
+            if (Plan_Passage(mouse_maze, r, c, dir, known_only))
+            {
+                next_r = r + (dir == NORTH) - (dir == SOUTH);
+                next_c = c + (dir == EAST) - (dir == WEST);
+                if (dist[next_r][next_c] == NO_ROUTE)
+                {
+                    dist[next_r][next_c] = dist[r][c] + 1;
+                    queue[tail++] = next_r * SIZE + next_c;
+                }
+            }
+    }
+}
+
+// Number of moves from every cell to the closest destination cell
+void Plan_Distances(unsigned int mouse_maze[SIZE][SIZE], unsigned int dist[SIZE][SIZE], unsigned int known_only)
+{
+    unsigned int r, c;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            dist[r][c] = Plan_Goal(mouse_maze, r, c, known_only) ? 0 : NO_ROUTE;
+
+    Plan_Flood(mouse_maze, dist, known_only);
+}
+
+// First move towards the closest cell not visited yet, through passages already seen (99 if none can be reached)
+unsigned int Plan_Frontier(unsigned int mouse_maze[SIZE][SIZE], unsigned int pos_y, unsigned int pos_x)
+{
+    unsigned int queue[SIZE * SIZE], first_dir[SIZE][SIZE], head = 0, tail = 0;
+    unsigned int r, c, dir, next_r, next_c;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            first_dir[r][c] = 99;
+    first_dir[pos_y][pos_x] = NORTH;
+    queue[tail++] = pos_y * SIZE + pos_x;
+
+    while (head != tail)
+    {
+        r = queue[head] / SIZE;
+        c = queue[head] % SIZE;
+        head++;
+
+        if ((mouse_maze[r][c] & CELL_VISITED) != CELL_VISITED)
+            return first_dir[r][c];
+
+        for (dir = NORTH; dir <= WEST; dir++)
+            if (Plan_Passage(mouse_maze, r, c, dir, 1))
+            {
+                next_r = r + (dir == NORTH) - (dir == SOUTH);
+                next_c = c + (dir == EAST) - (dir == WEST);
+                if ((first_dir[next_r][next_c] == 99) && ((mouse_maze[next_r][next_c] & (CELL_OUT | CELL_VISITED)) != CELL_OUT))
+                {
+                    first_dir[next_r][next_c] = ((r == pos_y) && (c == pos_x)) ? dir : first_dir[r][c];
+                    queue[tail++] = next_r * SIZE + next_c;
+                }
+            }
+    }
+
+    return 99;
+}
+
+// Best route from the first cell to destination with the walls known so far
+// The route only uses certain passages, the bound is how many moves it could be longer than the optimal route
+const struct Route_Plan *Plan_Route(unsigned int mouse_maze[SIZE][SIZE], struct Plan_Cache *p_cache)
+{
+    unsigned int known_dist[SIZE][SIZE], optimistic_dist[SIZE][SIZE];
+    unsigned int r, c, dir, changed = !p_cache->valid, order = 1;
+
+    p_cache->queries += 1;
+
+    // The plan only changes when new walls/cells are found - re-use it otherwise
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            if (p_cache->known_cells[r][c] != (mouse_maze[r][c] & PLAN_BITS))
+            {
+                p_cache->known_cells[r][c] = mouse_maze[r][c] & PLAN_BITS;
+                changed = 1;
+            }
+
+    if (!changed)
+    {
+        p_cache->hits += 1;
+        return &p_cache->plan;
+    }
+
+    Plan_Distances(mouse_maze, known_dist, 1);
+    Plan_Distances(mouse_maze, optimistic_dist, 0);
+
+    p_cache->plan.known_len = known_dist[0][0];
+    p_cache->plan.optimistic_len = optimistic_dist[0][0];
+    p_cache->plan.bound = NO_ROUTE;
+    if ((known_dist[0][0] != NO_ROUTE) && (optimistic_dist[0][0] != NO_ROUTE))
+        p_cache->plan.bound = known_dist[0][0] - optimistic_dist[0][0];
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            p_cache->plan.route[r][c] = 0;
+
+    // Following the decreasing distance from the first cell
+    if (known_dist[0][0] != NO_ROUTE)
+    {
+        r = c = 0;
+        p_cache->plan.route[r][c] = order;
+        while (known_dist[r][c] != 0)
+        {
+            for (dir = NORTH; dir <= WEST; dir++)
+                if (Plan_Passage(mouse_maze, r, c, dir, 1) &&
+                    (known_dist[r + (dir == NORTH) - (dir == SOUTH)][c + (dir == EAST) - (dir == WEST)] == known_dist[r][c] - 1))
+                    break;
+
+            r = r + (dir == NORTH) - (dir == SOUTH);
+            c = c + (dir == EAST) - (dir == WEST);
+            p_cache->plan.route[r][c] = ++order;
+        }
+    }
+
+    p_cache->valid = 1;
+    return &p_cache->plan;
+}
+
+unsigned long long Time_Ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// Processor time used by the calling thread - other threads (index workers, pipeline) are not counted
+unsigned long long Thread_Time_Ns(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec now;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+#else
+    return ((unsigned long long)clock() * 1000000000ULL) / CLOCKS_PER_SEC;
+#endif
+}
+
+const char *End_Reason_Name(unsigned int end_reason)
+{
+    const char *names[] = {"none", "complete", "moves", "time", "decision-time", "stuck"};
+
+    return (end_reason <= END_LAST) ? names[end_reason] : "unknown";
+}
+
+void Budget_Setup(struct Budget_Tracker *p_tracker)
+{
+    p_tracker->moves = 0;
+    p_tracker->start_ns = Time_Ns();
+    p_tracker->decision_start_ns = 0;
+    p_tracker->decision_ns = 0;
+}
+
+// Clock of a single decision, around Mouse_Exploring only - it is only read when the decision budget is set
+void Budget_Decision_Start(const struct Explore_Budget *p_budget, struct Budget_Tracker *p_tracker)
+{
+    if (p_budget->max_decision_us)
+        p_tracker->decision_start_ns = Thread_Time_Ns();
+}
+
+void Budget_Decision_Stop(const struct Explore_Budget *p_budget, struct Budget_Tracker *p_tracker)
+{
+    if (p_budget->max_decision_us)
+        p_tracker->decision_ns = Thread_Time_Ns() - p_tracker->decision_start_ns;
+}
+
+// Called after every decision - returns why the exploration has to stop (END_NONE if it can carry on)
+// The wall clock is only read when its budget is set
+unsigned int Budget_Check(const struct Explore_Budget *p_budget, struct Budget_Tracker *p_tracker, unsigned int moved)
+{
+    if (p_budget->max_decision_us && (p_tracker->decision_ns / 1000 > p_budget->max_decision_us))
+        return END_DECISION_TIME;
+    // Nothing has changed - the next decision would be the same one
+    if (!moved)
+        return END_STUCK;
+
+    p_tracker->moves += 1;
+    if (p_budget->max_moves && (p_tracker->moves >= p_budget->max_moves))
+        return END_MOVES;
+    if (p_budget->max_time_ms && ((Time_Ns() - p_tracker->start_ns) / 1000000 >= p_budget->max_time_ms))
+        return END_TIME;
+
+    return END_NONE;
+}
+
+// Exploration stopped early: going back to the first cell through the known passages
+// and marking the best known route (CELL_USED) instead of Solving
+// Returns the moves made to get back
+unsigned int Return_And_Solve(unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse)
+{
+    unsigned int dist[SIZE][SIZE], r, c, dir, moves = 0;
+    struct Plan_Cache plan_cache;
+    const struct Route_Plan *p_plan;
+
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            dist[r][c] = NO_ROUTE;
+    dist[0][0] = 0;
+    Plan_Flood(mouse_maze, dist, 1);
+
+    // Following the decreasing distance to the first cell
+    if (dist[p_mouse->pos_y][p_mouse->pos_x] != NO_ROUTE)
+        while (dist[p_mouse->pos_y][p_mouse->pos_x] != 0)
+        {
+            for (dir = NORTH; dir <= WEST; dir++)
+                if (Plan_Passage(mouse_maze, p_mouse->pos_y, p_mouse->pos_x, dir, 1) &&
+                    (dist[p_mouse->pos_y + (dir == NORTH) - (dir == SOUTH)][p_mouse->pos_x + (dir == EAST) - (dir == WEST)] == dist[p_mouse->pos_y][p_mouse->pos_x] - 1))
+                    break;
+
+            p_mouse->prev_cell_x = p_mouse->pos_x;
+            p_mouse->prev_cell_y = p_mouse->pos_y;
+            p_mouse->m_dir = dir;
+            p_mouse->pos_y = p_mouse->pos_y + (dir == NORTH) - (dir == SOUTH);
+            p_mouse->pos_x = p_mouse->pos_x + (dir == EAST) - (dir == WEST);
+            moves++;
+        }
+
+    Plan_Cache_Setup(&plan_cache);
+    p_plan = Plan_Route(mouse_maze, &plan_cache);
+    for (r = 0; r < SIZE; r++)
+        for (c = 0; c < SIZE; c++)
+            if (p_plan->route[r][c] > 0)
+                mouse_maze[r][c] |= CELL_USED;
+
+    return moves;
+}
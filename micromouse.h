@@ -0,0 +1,147 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#ifndef MICROMOUSE_H
+#define MICROMOUSE_H
+
+#define SIZE 8 // MAX Maze Length
+// Default maze size
+#define LENGTH 6
+#define HEIGHT 8
+
+#define BITS 15          // 4 bits/walls around each cell
+#define TOT_CELLS 48     // Total number of cells to be found
+#define TOT_DEST_CELLS 4 // Number of destination cells
+#define Y_DEST 3         // Destination y-coordinate
+#define X_DEST 3         // Destination x-coordinate
+#define LAST_VIS_CELLS 4 // Last temporary visited cells
+
+// Walls
+#define NORTH_WALL 0b1000 // 8
+#define EAST_WALL 0b0100  // 4
+#define SOUTH_WALL 0b0010 // 2
+#define WEST_WALL 0b0001  // 1
+
+#define VERT_WALLS (NORTH_WALL | SOUTH_WALL)
+#define HORIZ_WALLS (WEST_WALL | EAST_WALL)
+
+// Cells Checking
+#define CELL_VISITED 0b10000 // 16
+#define CELL_USED 0b100000   // 32 - Cell used for the final route
+#define CELL_OUT 0b1000000   // 64 - Out of Bound
+#define DEST_CELL 0b10000000 // 128 - Destination cells
+
+// Mouse Pointing Direction
+#define NORTH 0
+#define EAST 1
+#define SOUTH 2
+#define WEST 3
+
+// Partial-Knowledge Planner
+#define NO_ROUTE 999                                           // Distance given to cells with no route to destination
+#define PLAN_BITS (BITS | CELL_VISITED | CELL_OUT | DEST_CELL) // Cell values the plan depends on
+
+// Exploration End Reasons
+#define END_NONE 0          // Still exploring
+#define END_COMPLETE 1      // Exploration completed
+#define END_MOVES 2         // Out of moves
+#define END_TIME 3          // Out of time (wall-clock)
+#define END_DECISION_TIME 4 // A decision took too long (CPU time)
+#define END_STUCK 5         // The mouse cannot move anymore
+#define END_LAST END_STUCK  // Highest end reason
+
+// Maze as written in mazes.txt - top row first, bits set where there is NO wall
+struct Maze_Route
+{
+    unsigned int rows, cols;
+    unsigned int cells[SIZE][SIZE];
+};
+
+struct Mouse_Settings
+{
+    unsigned int pos_x, pos_y;   // Current position and orientation
+    unsigned int dirs[4], m_dir; // 4 possible directions of the mouse
+    unsigned int sides_found, dest_cells_found, destination_found, cells_found;
+    unsigned int prev_cells[SIZE][SIZE], prev_cell, prev_cell_x, prev_cell_y; // where the last # visited cells will be stored
+};
+
+struct Route_Plan
+{
+    unsigned int known_len, optimistic_len, bound; // Moves of the best known route, lower bound, max distance from optimal
+    unsigned int route[SIZE][SIZE];                // Route order from the first cell (1) to destination - 0 if not used
+};
+
+struct Plan_Cache
+{
+    unsigned int known_cells[SIZE][SIZE]; // Walls and flags the cached plan was computed from
+    unsigned int valid, queries, hits;
+    struct Route_Plan plan;
+};
+
+// Exploration limits - 0 = no limit
+struct Explore_Budget
+{
+    unsigned int max_moves;
+    unsigned long max_time_ms, max_decision_us;
+};
+
+struct Budget_Tracker
+{
+    unsigned int moves; // Decisions leaving the mouse in the same cell are not moves
+    unsigned long long start_ns;
+    unsigned long long decision_start_ns; // Processor time of this thread when the last decision started
+    unsigned long long decision_ns;       // Processor time taken by the last decision
+};
+
+void Generate_Maze(unsigned int maze[SIZE][SIZE]);
+void Generate_Route(unsigned int maze[SIZE][SIZE], const struct Maze_Route *p_route);
+void Print_Maze(unsigned int maze[SIZE][SIZE], const struct Maze_Route *p_route);
+void Print_Mouse_Maze(unsigned int mouse_maze[SIZE][SIZE]);
+void Mouse_Setup(struct Mouse_Settings *p_mouse);
+void Mouse_Maze_Setup(unsigned int mouse_maze[SIZE][SIZE]);
+void Mouse_Exploring(unsigned int maze[SIZE][SIZE], unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse, unsigned int discovered_cells[SIZE][SIZE]);
+void Walls_Check(unsigned int maze[SIZE][SIZE], struct Mouse_Settings *p_mouse, unsigned int mouse_maze[SIZE][SIZE]);
+void Solving(unsigned int mouse_maze[SIZE][SIZE], unsigned int discovered_cells[SIZE][SIZE]);
+void ToDest(unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse);
+void Plan_Cache_Setup(struct Plan_Cache *p_cache);
+unsigned int Plan_Passage(unsigned int mouse_maze[SIZE][SIZE], unsigned int r, unsigned int c, unsigned int dir, unsigned int known_only);
+unsigned int Plan_Side_Out(unsigned int mouse_maze[SIZE][SIZE], unsigned int top);
+unsigned int Plan_Goal(unsigned int mouse_maze[SIZE][SIZE], unsigned int r, unsigned int c, unsigned int known_only);
+void Plan_Flood(unsigned int mouse_maze[SIZE][SIZE], unsigned int dist[SIZE][SIZE], unsigned int known_only);
+void Plan_Distances(unsigned int mouse_maze[SIZE][SIZE], unsigned int dist[SIZE][SIZE], unsigned int known_only);
+unsigned int Plan_Frontier(unsigned int mouse_maze[SIZE][SIZE], unsigned int pos_y, unsigned int pos_x);
+const struct Route_Plan *Plan_Route(unsigned int mouse_maze[SIZE][SIZE], struct Plan_Cache *p_cache);
+unsigned long long Time_Ns(void);
+unsigned long long Thread_Time_Ns(void);
+const char *End_Reason_Name(unsigned int end_reason);
+void Budget_Setup(struct Budget_Tracker *p_tracker);
+void Budget_Decision_Start(const struct Explore_Budget *p_budget, struct Budget_Tracker *p_tracker);
+void Budget_Decision_Stop(const struct Explore_Budget *p_budget, struct Budget_Tracker *p_tracker);
+unsigned int Budget_Check(const struct Explore_Budget *p_budget, struct Budget_Tracker *p_tracker, unsigned int moved);
+unsigned int Return_And_Solve(unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse);
+
+#endif
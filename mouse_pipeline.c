@@ -0,0 +1,217 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "mouse_pipeline.h"
+
+// Giving each cell a number the first time the mouse gets in it
+void Number_Cell(struct Mouse_Settings *p_mouse, unsigned int discovered_cells[SIZE][SIZE], unsigned int *p_count)
+{
+    if (discovered_cells[p_mouse->pos_y][p_mouse->pos_x] == 0)
+    {
+        discovered_cells[p_mouse->pos_y][p_mouse->pos_x] = *p_count;
+        *p_count += 1;
+    }
+}
+
+void *Pipeline_Worker(void *p_arg)
+{
+    struct Mouse_Pipeline *p_pipe = p_arg;
+    unsigned int expected_maze[SIZE][SIZE];
+    unsigned int r, c;
+    unsigned long long start, cpu_start;
+
+    pthread_mutex_lock(&p_pipe->lock);
+    while (1)
+    {
+        while ((p_pipe->worker_state == WORKER_IDLE) || (p_pipe->worker_state == WORKER_DONE))
+            pthread_cond_wait(&p_pipe->signal, &p_pipe->lock);
+        if (p_pipe->worker_state == WORKER_QUIT)
+            break;
+        pthread_mutex_unlock(&p_pipe->lock);
+
+        start = Time_Ns();
+
+        // Expected sensing - only the walls already known are there
+        for (r = 0; r < SIZE; r++)
+            for (c = 0; c < SIZE; c++)
+                expected_maze[r][c] = p_pipe->expected.mouse_maze[r][c] & BITS;
+        Walls_Check(expected_maze, &p_pipe->expected.mouse, p_pipe->expected.mouse_maze);
+        Number_Cell(&p_pipe->expected.mouse, p_pipe->expected.discovered_cells, &p_pipe->expected.count);
+
+        // Next decision from the expected map
+        p_pipe->decided = p_pipe->expected;
+        cpu_start = Thread_Time_Ns();
+        Mouse_Exploring(expected_maze, p_pipe->decided.mouse_maze, &p_pipe->decided.mouse, p_pipe->decided.discovered_cells);
+        p_pipe->plan_cpu_ns = Thread_Time_Ns() - cpu_start;
+
+        p_pipe->done_ns = Time_Ns();
+        p_pipe->plan_ns = p_pipe->done_ns - start;
+
+        pthread_mutex_lock(&p_pipe->lock);
+        p_pipe->worker_state = WORKER_DONE;
+        pthread_cond_broadcast(&p_pipe->signal);
+    }
+    pthread_mutex_unlock(&p_pipe->lock);
+
+    return NULL;
+}
+
+int Pipeline_Setup(struct Mouse_Pipeline *p_pipe, unsigned int move_us, FILE *log)
+{
+    p_pipe->worker_state = WORKER_IDLE;
+    p_pipe->ready = 0;
+    p_pipe->move_us = move_us;
+    p_pipe->steps = 0;
+    p_pipe->hits = 0;
+    p_pipe->hidden_ns = 0;
+    p_pipe->exposed_ns = 0;
+    p_pipe->handoff_ns = 0;
+    p_pipe->decided_cpu_ns = 0;
+    p_pipe->decision_cpu_ns = 0;
+    p_pipe->log = log;
+
+    pthread_mutex_init(&p_pipe->lock, NULL);
+    pthread_cond_init(&p_pipe->signal, NULL);
+    return pthread_create(&p_pipe->thread, NULL, Pipeline_Worker, p_pipe);
+}
+
+// Same as Mouse_Exploring + Walls_Check + numbering the cell, but the next decision is computed during the move
+void Pipeline_Step(struct Mouse_Pipeline *p_pipe, unsigned int maze[SIZE][SIZE], unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse, unsigned int discovered_cells[SIZE][SIZE], unsigned int *p_count)
+{
+    unsigned long long start, cpu_start, step_exposed_ns = 0, step_hidden_ns = 0, plan_wait_ns, handoff_ns;
+    unsigned int hit;
+    struct timespec move_time;
+
+    //--- Decision and Movement ---
+    if (p_pipe->ready)
+    {
+        // Decision already taken - while moving to the current cell, or once it was sensed if the speculation missed
+        *p_mouse = p_pipe->decided.mouse;
+        memcpy(mouse_maze, p_pipe->decided.mouse_maze, sizeof(p_pipe->decided.mouse_maze));
+        p_pipe->decision_cpu_ns = p_pipe->decided_cpu_ns;
+    }
+    else
+    {
+        // First move - nothing has been sensed to decide in advance
+        start = Time_Ns();
+        cpu_start = Thread_Time_Ns();
+        Mouse_Exploring(maze, mouse_maze, p_mouse, discovered_cells);
+        p_pipe->decision_cpu_ns = Thread_Time_Ns() - cpu_start;
+        step_exposed_ns = Time_Ns() - start;
+    }
+
+    //--- Planning next decision while moving ---
+    p_pipe->expected.mouse = *p_mouse;
+    memcpy(p_pipe->expected.mouse_maze, mouse_maze, sizeof(p_pipe->expected.mouse_maze));
+    memcpy(p_pipe->expected.discovered_cells, discovered_cells, sizeof(p_pipe->expected.discovered_cells));
+    p_pipe->expected.count = *p_count;
+
+    pthread_mutex_lock(&p_pipe->lock);
+    p_pipe->worker_state = WORKER_PLANNING;
+    pthread_cond_broadcast(&p_pipe->signal);
+    pthread_mutex_unlock(&p_pipe->lock);
+
+    // Simulation purposes - time taken by the motors to get to the next cell
+    if (p_pipe->move_us)
+    {
+        move_time.tv_sec = p_pipe->move_us / 1000000;
+        move_time.tv_nsec = (p_pipe->move_us % 1000000) * 1000L;
+        nanosleep(&move_time, NULL);
+    }
+
+    //--- Sensing ---
+    Walls_Check(maze, p_mouse, mouse_maze);
+    Number_Cell(p_mouse, discovered_cells, p_count);
+
+    // Waiting for the next decision
+    start = Time_Ns();
+    pthread_mutex_lock(&p_pipe->lock);
+    while (p_pipe->worker_state != WORKER_DONE)
+        pthread_cond_wait(&p_pipe->signal, &p_pipe->lock);
+    p_pipe->worker_state = WORKER_IDLE;
+    pthread_mutex_unlock(&p_pipe->lock);
+    handoff_ns = Time_Ns() - start;
+
+    // Part of the wait the worker was still planning, the rest is the handoff between the threads
+    plan_wait_ns = (p_pipe->done_ns > start) ? p_pipe->done_ns - start : 0;
+    if (plan_wait_ns > p_pipe->plan_ns)
+        plan_wait_ns = p_pipe->plan_ns;
+    handoff_ns -= plan_wait_ns;
+    step_exposed_ns += plan_wait_ns;
+
+    // The decision is only valid if the mouse sensed what was expected
+    hit =
+        (memcmp(&p_pipe->expected.mouse, p_mouse, sizeof(*p_mouse)) == 0) &&
+        (memcmp(p_pipe->expected.mouse_maze, mouse_maze, sizeof(p_pipe->expected.mouse_maze)) == 0) &&
+        (memcmp(p_pipe->expected.discovered_cells, discovered_cells, sizeof(p_pipe->expected.discovered_cells)) == 0);
+
+    if (hit)
+    {
+        step_hidden_ns = p_pipe->plan_ns - plan_wait_ns;
+        p_pipe->decided_cpu_ns = p_pipe->plan_cpu_ns;
+    }
+    else
+    {
+        // The sensed walls were not the expected ones - deciding again before the next move
+        p_pipe->decided.mouse = *p_mouse;
+        memcpy(p_pipe->decided.mouse_maze, mouse_maze, sizeof(p_pipe->decided.mouse_maze));
+        start = Time_Ns();
+        cpu_start = Thread_Time_Ns();
+        Mouse_Exploring(maze, p_pipe->decided.mouse_maze, &p_pipe->decided.mouse, discovered_cells);
+        p_pipe->decided_cpu_ns = Thread_Time_Ns() - cpu_start;
+        step_exposed_ns += Time_Ns() - start;
+    }
+    p_pipe->ready = 1;
+
+    p_pipe->steps += 1;
+    p_pipe->hits += hit;
+    p_pipe->hidden_ns += step_hidden_ns;
+    p_pipe->exposed_ns += step_exposed_ns;
+    p_pipe->handoff_ns += handoff_ns;
+
+    // Exposed time = planning the mouse waited for + decision computed again on a miss
+    if (p_pipe->log != NULL)
+        fprintf(p_pipe->log, "step = %u\tspeculation = %s\tplan_ns = %llu\thidden_ns = %llu\texposed_ns = %llu\thandoff_ns = %llu\n",
+                p_pipe->steps, hit ? "hit" : "miss", p_pipe->plan_ns, step_hidden_ns, step_exposed_ns, handoff_ns);
+}
+
+void Pipeline_Close(struct Mouse_Pipeline *p_pipe)
+{
+    pthread_mutex_lock(&p_pipe->lock);
+    p_pipe->worker_state = WORKER_QUIT;
+    pthread_cond_broadcast(&p_pipe->signal);
+    pthread_mutex_unlock(&p_pipe->lock);
+
+    pthread_join(p_pipe->thread, NULL);
+    pthread_mutex_destroy(&p_pipe->lock);
+    pthread_cond_destroy(&p_pipe->signal);
+}
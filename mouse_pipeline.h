@@ -0,0 +1,78 @@
+/*
+**************************************************************************************
+* Micromouse Algorithm
+*
+* Copyright (c) 2023 Alessandro Amatucci Girlanda
+*
+* This work is licensed under the Creative Commons Attribution-NonCommercial-ShareAlike
+* 4.0 International License. To view a copy of this license, visit
+* http://creativecommons.org/licenses/by-nc-sa/4.0/ or send a letter to Creative
+* Commons, PO Box 1866, Mountain View, CA 94042, USA.
+*
+* You are free to:
+*   - Share — copy and redistribute the material in any medium or format
+*   - Adapt — remix, transform, and build upon the material
+*
+* Under the following terms:
+*   - Attribution — You must give appropriate credit, provide a link to the license, and
+*                  indicate if changes were made. You may do so in any reasonable manner,
+*                  but not in any way that suggests the licensor endorses you or your use.
+*   - NonCommercial — You may not use the material for commercial purposes.
+*   - ShareAlike — If you remix, transform, or build upon the material, you must
+*                  distribute your contributions under the same license as the original.
+*
+* No additional restrictions — You may not apply legal terms or technological measures
+* that legally restrict others from doing anything the license permits.
+*/
+
+#ifndef MOUSE_PIPELINE_H
+#define MOUSE_PIPELINE_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include "micromouse.h"
+
+// Worker States
+#define WORKER_IDLE 0
+#define WORKER_PLANNING 1
+#define WORKER_DONE 2
+#define WORKER_QUIT 3
+
+// Mouse state the next decision is computed from
+struct Mouse_State
+{
+    struct Mouse_Settings mouse;
+    unsigned int mouse_maze[SIZE][SIZE];
+    unsigned int discovered_cells[SIZE][SIZE];
+    unsigned int count; // Number given to the next discovered cell
+};
+
+// Next decision computed while the mouse is moving
+// The walls not seen yet are expected to be open, if the mouse senses a different cell the decision is computed again
+struct Mouse_Pipeline
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t signal;
+    unsigned int worker_state, ready, move_us; // ready - decided holds the next decision
+
+    struct Mouse_State expected;        // State expected after the move - compared with the sensed one
+    struct Mouse_State decided;         // State after the speculative decision (and its move)
+    unsigned long long plan_ns;         // Time taken by the speculative decision
+    unsigned long long done_ns;         // When the speculative decision was ready
+    unsigned long long plan_cpu_ns;     // Processor time of the speculative decision
+    unsigned long long decided_cpu_ns;  // Processor time of the decision held in decided (speculative or computed again)
+    unsigned long long decision_cpu_ns; // Processor time of the decision applied in the last step
+
+    unsigned int steps, hits;
+    unsigned long long hidden_ns, exposed_ns; // Planning time overlapped with the movement / added to it
+    unsigned long long handoff_ns;            // Waking up and locking - not planning
+    FILE *log;
+};
+
+int Pipeline_Setup(struct Mouse_Pipeline *p_pipe, unsigned int move_us, FILE *log);
+void Pipeline_Step(struct Mouse_Pipeline *p_pipe, unsigned int maze[SIZE][SIZE], unsigned int mouse_maze[SIZE][SIZE], struct Mouse_Settings *p_mouse, unsigned int discovered_cells[SIZE][SIZE], unsigned int *p_count);
+void Pipeline_Close(struct Mouse_Pipeline *p_pipe);
+
+#endif